@@ -0,0 +1,35 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec3 normal;
+
+out vec3 v_Normal;
+
+uniform mat4 u_MVP;
+uniform mat4 u_Model;
+
+void main()
+{
+   gl_Position = u_MVP * vec4(position, 1.0);
+   v_Normal = mat3(u_Model) * normal;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform vec4 u_Color;
+
+in vec3 v_Normal;
+
+void main()
+{
+    // 简单的方向光 + 环境光
+    vec3 lightDir = normalize(vec3(0.4, 0.8, 0.6));
+    float diffuse = max(dot(normalize(v_Normal), lightDir), 0.0);
+    color = vec4(u_Color.rgb * (0.2 + 0.8 * diffuse), u_Color.a);
+};
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 corner;
+// 每个实例（粒子）的数据
+layout(location = 1) in float positionX;
+layout(location = 2) in float positionY;
+layout(location = 3) in float life;
+layout(location = 4) in float maxLife;
+
+out vec4 v_Color;
+out vec2 v_Corner;
+
+uniform mat4 u_MVP;
+uniform float u_Size;
+
+void main()
+{
+   // t: 1 为刚发射，0 为即将消失；life <= 0 的粒子（GPU 模式中等待发射的）缩成一个点
+   float t = clamp(life / max(maxLife, 0.0001), 0.0, 1.0);
+   float size = life > 0.0 ? u_Size * (0.5 + t) : 0.0;
+   gl_Position = u_MVP * vec4(vec2(positionX, positionY) + corner * size, 0.0, 1.0);
+   v_Color = mix(vec4(0.9, 0.15, 0.05, 0.0), vec4(1.0, 0.8, 0.35, 1.0), t);
+   v_Corner = corner * 2.0;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_Corner;
+
+void main()
+{
+    // 圆形软边，加法混合下直接输出预乘后的颜色
+    float falloff = max(1.0 - dot(v_Corner, v_Corner), 0.0);
+    color = vec4(v_Color.rgb * v_Color.a * falloff, 0.0);
+};
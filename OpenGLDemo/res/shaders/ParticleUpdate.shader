@@ -0,0 +1,64 @@
+#shader vertex
+#version 330 core
+
+// transform feedback 模拟：每个粒子一个顶点，结果写入另一个缓冲，没有片段着色器
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 velocity;
+layout(location = 2) in float life;
+layout(location = 3) in float maxLife;
+
+out vec2 tf_Position;
+out vec2 tf_Velocity;
+out float tf_Life;
+out float tf_MaxLife;
+
+uniform float u_DeltaTime;
+uniform int u_Frame;
+uniform vec4 u_Emitter;     // x, y, direction, spread
+uniform vec4 u_Motion;      // speed, lifetime, gravity, drag
+
+// PCG 哈希，返回 [0, 1)
+float Random(inout uint state)
+{
+    state = state * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    word = (word >> 22u) ^ word;
+    return float(word) / 4294967296.0;
+}
+
+void Respawn(uint seed)
+{
+    uint state = seed;
+    float angle = u_Emitter.z + (Random(state) - 0.5) * u_Emitter.w;
+    float speed = u_Motion.x * (0.5 + 0.5 * Random(state));
+    tf_Position = u_Emitter.xy;
+    tf_Velocity = vec2(cos(angle), sin(angle)) * speed;
+    tf_Life = u_Motion.y * (0.5 + 0.5 * Random(state));
+    tf_MaxLife = tf_Life;
+}
+
+void main()
+{
+    uint seed = uint(gl_VertexID) * 1973u + uint(u_Frame) * 9277u;
+
+    tf_Position = position;
+    tf_Velocity = velocity;
+    tf_MaxLife = maxLife;
+
+    // life < 0：还在等待第一次发射
+    if (life < 0.0)
+    {
+        tf_Life = min(life + u_DeltaTime, 0.0);
+        if (tf_Life == 0.0)
+            Respawn(seed);
+        return;
+    }
+
+    float damping = max(1.0 - u_Motion.w * u_DeltaTime, 0.0);
+    tf_Velocity = vec2(velocity.x, velocity.y + u_Motion.z * u_DeltaTime) * damping;
+    tf_Position = position + tf_Velocity * u_DeltaTime;
+    tf_Life = life - u_DeltaTime;
+    if (tf_Life <= 0.0)
+        Respawn(seed);
+};
@@ -0,0 +1,96 @@
+#pragma permutation THRESHOLD BLUR EDGES
+#pragma permutation BLOOM SHOW_EDGES
+
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    // 覆盖全屏的三角形，由 gl_VertexID 生成，不需要顶点缓冲
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = p;
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Color.glsl"
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Source;
+
+in vec2 v_TexCoord;
+
+#if defined(THRESHOLD)
+
+uniform float u_Threshold;
+
+void main()
+{
+    vec3 c = texture(u_Source, v_TexCoord).rgb;
+    float l = Luminance(c);
+    color = vec4(c * (max(l - u_Threshold, 0.0) / max(l, 0.0001)), 1.0);
+}
+
+#elif defined(BLUR)
+
+// 一个 texel 的偏移乘以方向
+uniform vec2 u_Direction;
+
+void main()
+{
+    // 9 tap 高斯，利用线性过滤合并为 5 次采样
+    vec3 c = texture(u_Source, v_TexCoord).rgb * 0.2270270270;
+    c += texture(u_Source, v_TexCoord + u_Direction * 1.3846153846).rgb * 0.3162162162;
+    c += texture(u_Source, v_TexCoord - u_Direction * 1.3846153846).rgb * 0.3162162162;
+    c += texture(u_Source, v_TexCoord + u_Direction * 3.2307692308).rgb * 0.0702702703;
+    c += texture(u_Source, v_TexCoord - u_Direction * 3.2307692308).rgb * 0.0702702703;
+    color = vec4(c, 1.0);
+}
+
+#elif defined(EDGES)
+
+void main()
+{
+    // Sobel 亮度边缘
+    vec2 texel = 1.0 / vec2(textureSize(u_Source, 0));
+    float l[9];
+    for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 3; x++)
+            l[y * 3 + x] = Luminance(texture(u_Source, v_TexCoord + vec2(x - 1, y - 1) * texel).rgb);
+    float gx = (l[2] + 2.0 * l[5] + l[8]) - (l[0] + 2.0 * l[3] + l[6]);
+    float gy = (l[6] + 2.0 * l[7] + l[8]) - (l[0] + 2.0 * l[1] + l[2]);
+    color = vec4(clamp(length(vec2(gx, gy)), 0.0, 1.0));
+}
+
+#else
+
+// 合成：场景 + bloom，曝光后色调映射
+uniform float u_Exposure;
+#ifdef BLOOM
+uniform sampler2D u_Bloom;
+uniform float u_BloomIntensity;
+#endif
+#ifdef SHOW_EDGES
+uniform sampler2D u_Edges;
+#endif
+
+void main()
+{
+    vec3 hdr = texture(u_Source, v_TexCoord).rgb;
+#ifdef BLOOM
+    hdr += texture(u_Bloom, v_TexCoord).rgb * u_BloomIntensity;
+#endif
+    vec3 ldr = vec3(1.0) - exp(-hdr * u_Exposure);
+#ifdef SHOW_EDGES
+    ldr = mix(ldr, vec3(1.0, 0.8, 0.1), texture(u_Edges, v_TexCoord).r);
+#endif
+    color = vec4(ldr, 1.0);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+   gl_Position = u_MVP * position;
+   v_TexCoord = texCoord;
+   v_Color = color;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Texture;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+void main()
+{
+    // 0.5 为轮廓，按屏幕空间导数决定过渡宽度，任意缩放下边缘都保持约 1 像素的抗锯齿
+    float distance = texture(u_Texture, v_TexCoord).r;
+    float width = max(fwidth(distance) * 0.7, 0.001);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    color = vec4(v_Color.rgb, v_Color.a * alpha);
+};
@@ -0,0 +1,44 @@
+#pragma permutation ALPHA_TEST
+
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+   gl_Position = u_MVP * position;
+   v_TexCoord = texCoord;
+};
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Overdraw.glsl"
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Texture;
+uniform vec4 u_Color;
+#ifdef ALPHA_TEST
+uniform float u_AlphaCutoff;
+#endif
+
+in vec2 v_TexCoord;
+
+void main()
+{
+    vec4 texColor = texture(u_Texture, v_TexCoord) * u_Color;
+#ifdef ALPHA_TEST
+    // alpha 测试：丢弃透明像素，不需要混合和排序
+    if (texColor.a < u_AlphaCutoff)
+        discard;
+#endif
+    color = ApplyOverdraw(texColor);
+};
@@ -0,0 +1,32 @@
+#shader vertex
+#version 330 core
+
+// 瓦片坐标（unsigned short，不归一化）
+layout(location = 0) in vec2 position;
+// 图集坐标（unsigned short，归一化）
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+   gl_Position = u_MVP * vec4(position, 0.0, 1.0);
+   v_TexCoord = texCoord;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Texture;
+
+in vec2 v_TexCoord;
+
+void main()
+{
+    color = texture(u_Texture, v_TexCoord);
+};
@@ -0,0 +1,66 @@
+#pragma permutation TEXTURED TINT GRAYSCALE
+#pragma permutation VIGNETTE CHECKER ANIMATE
+
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+#ifdef ANIMATE
+uniform float u_Time;
+#endif
+
+void main()
+{
+   vec4 p = position;
+#ifdef ANIMATE
+   p.y += sin(u_Time * 2.0 + p.x * 3.0) * 0.1;
+#endif
+   gl_Position = u_MVP * p;
+   v_TexCoord = texCoord;
+};
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Color.glsl"
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Texture;
+uniform vec4 u_Color;
+#ifdef ANIMATE
+uniform float u_Time;
+#endif
+
+in vec2 v_TexCoord;
+
+void main()
+{
+    vec4 result = vec4(v_TexCoord, 0.5, 1.0);
+#ifdef TEXTURED
+    result = texture(u_Texture, v_TexCoord);
+#endif
+#ifdef CHECKER
+    vec2 cell = floor(v_TexCoord * 8.0);
+    result.rgb *= mod(cell.x + cell.y, 2.0) < 1.0 ? 1.0 : 0.6;
+#endif
+#ifdef TINT
+    result *= u_Color;
+#endif
+#ifdef GRAYSCALE
+    result.rgb = vec3(Luminance(result.rgb));
+#endif
+#ifdef VIGNETTE
+    result.rgb *= Vignette(v_TexCoord);
+#endif
+#ifdef ANIMATE
+    result.rgb *= 0.75 + 0.25 * sin(u_Time * 4.0);
+#endif
+    color = result;
+};
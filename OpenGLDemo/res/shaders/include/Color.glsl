@@ -0,0 +1,11 @@
+float Luminance(vec3 color)
+{
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// 边缘压暗，uv 为 [0, 1]
+float Vignette(vec2 uv)
+{
+    vec2 d = uv - 0.5;
+    return clamp(1.0 - dot(d, d) * 2.0, 0.0, 1.0);
+}
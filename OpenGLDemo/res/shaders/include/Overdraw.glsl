@@ -0,0 +1,7 @@
+uniform vec4 u_OverdrawColor;
+
+// u_OverdrawColor.a > 0 时输出固定颜色，配合加法混合显示每个像素被着色的次数
+vec4 ApplyOverdraw(vec4 color)
+{
+    return u_OverdrawColor.a > 0.0 ? u_OverdrawColor : color;
+}
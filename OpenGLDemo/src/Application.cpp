@@ -5,10 +5,177 @@
 
 #include "test/TestClearColor.h"
 #include "test/TestTexture2D.h"
+#include "test/TestMesh.h"
+#include "test/TestSpriteOverdraw.h"
+#include "test/TestText.h"
+#include "test/TestParticles.h"
+#include "test/TestAllocations.h"
+#include "test/TestShaderVariants.h"
+#include "test/TestRenderGraph.h"
+#include "test/TestTilemap.h"
+#include "test/TestOnDemand.h"
 
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_glfw_gl3.h>
 #include <Renderer.h>
+#include "MemoryTracker.h"
+#include "FrameArena.h"
+#include "Shader.h"
+#include "RenderScheduler.h"
+
+// ImGui 默认直接用 malloc，改为经过 MemoryTracker 并打上 ImGui 标签
+static void* ImGuiAlloc(size_t size, void*)
+{
+    MemoryTagScope tag(MemoryTag::ImGui);
+    return MemoryTracker::Allocate(size);
+}
+
+static void ImGuiFree(void* pointer, void*)
+{
+    MemoryTracker::Free(pointer);
+}
+
+static void ShowMemoryStats()
+{
+    MemoryTagStats total = MemoryTracker::GetFrameTotal();
+    if (!ImGui::TreeNode("Memory", "Heap: %llu allocs / %llu bytes per frame", total.Allocations, total.Bytes))
+        return;
+
+    ImGui::Columns(4);
+    ImGui::Text("Tag"); ImGui::NextColumn();
+    ImGui::Text("Allocs/Frame"); ImGui::NextColumn();
+    ImGui::Text("Bytes/Frame"); ImGui::NextColumn();
+    ImGui::Text("Live"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (int i = 0; i < (int)MemoryTag::Count; i++)
+    {
+        MemoryTagStats stats = MemoryTracker::GetFrameStats((MemoryTag)i);
+        ImGui::Text("%s", MemoryTracker::GetTagName((MemoryTag)i)); ImGui::NextColumn();
+        ImGui::Text("%llu", stats.Allocations); ImGui::NextColumn();
+        ImGui::Text("%llu", stats.Bytes); ImGui::NextColumn();
+        ImGui::Text("%lld (%.1f KB)", stats.LiveAllocations, stats.LiveBytes / 1024.0); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    const LinearArena& arena = FrameArena::Get().GetCurrent();
+    ImGui::Text("Frame Arena: %.1f / %.1f KB (peak %.1f KB, overflow %u)",
+        arena.GetUsed() / 1024.0, arena.GetCapacity() / 1024.0, arena.GetPeak() / 1024.0, arena.GetOverflowCount());
+    ImGui::TreePop();
+}
+
+static void ShowRenderStats()
+{
+    RenderScheduler& scheduler = RenderScheduler::Get();
+    const RenderSchedulerStats& stats = scheduler.GetStats();
+    if (!ImGui::TreeNode("Rendering", "Frames: %llu active / %llu idle wakeups", stats.ActiveFrames, stats.IdleWakeups))
+        return;
+
+    bool onDemand = scheduler.IsOnDemand();
+    if (ImGui::Checkbox("On-Demand", &onDemand))
+        scheduler.SetOnDemand(onDemand);
+    ImGui::SameLine();
+    bool partialRedraw = scheduler.IsPartialRedraw();
+    if (ImGui::Checkbox("Partial Redraw", &partialRedraw))
+        scheduler.SetPartialRedraw(partialRedraw);
+
+    const DamageRect& damage = stats.LastDamage;
+    ImGui::Text("Content redraws: %llu (partial %llu), last %dx%d at %d,%d",
+        stats.ContentFrames, stats.PartialFrames, damage.Width, damage.Height, damage.X, damage.Y);
+
+    ImGui::Columns(4);
+    ImGui::Text("Mode"); ImGui::NextColumn();
+    ImGui::Text("CPU"); ImGui::NextColumn();
+    ImGui::Text("Frames/s"); ImGui::NextColumn();
+    ImGui::Text("Idle Wakeups/s"); ImGui::NextColumn();
+    ImGui::Separator();
+    const char* names[] = { "Continuous", "On-Demand" };
+    const RenderModeStats* modes[] = { &stats.Continuous, &stats.OnDemand };
+    for (int i = 0; i < 2; i++)
+    {
+        ImGui::Text("%s", names[i]); ImGui::NextColumn();
+        if (modes[i]->Measured)
+        {
+            ImGui::Text("%.1f%%", modes[i]->CpuPercent); ImGui::NextColumn();
+            ImGui::Text("%.1f", modes[i]->FramesPerSecond); ImGui::NextColumn();
+            ImGui::Text("%.1f", modes[i]->WakeupsPerSecond); ImGui::NextColumn();
+        }
+        else
+        {
+            ImGui::Text("-"); ImGui::NextColumn();
+            ImGui::Text("-"); ImGui::NextColumn();
+            ImGui::Text("-"); ImGui::NextColumn();
+        }
+    }
+    ImGui::Columns(1);
+    ImGui::TreePop();
+}
+
+// ImGui 安装的输入回调，先通知 RenderScheduler 再转发
+static GLFWmousebuttonfun s_PrevMouseButtonCallback;
+static GLFWscrollfun s_PrevScrollCallback;
+static GLFWkeyfun s_PrevKeyCallback;
+static GLFWcharfun s_PrevCharCallback;
+
+static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+    RenderScheduler::Get().NotifyInput();
+    if (s_PrevMouseButtonCallback)
+        s_PrevMouseButtonCallback(window, button, action, mods);
+}
+
+static void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    RenderScheduler::Get().NotifyInput();
+    if (s_PrevScrollCallback)
+        s_PrevScrollCallback(window, xoffset, yoffset);
+}
+
+static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    RenderScheduler::Get().NotifyInput();
+    if (s_PrevKeyCallback)
+        s_PrevKeyCallback(window, key, scancode, action, mods);
+}
+
+static void CharCallback(GLFWwindow* window, unsigned int c)
+{
+    RenderScheduler::Get().NotifyInput();
+    if (s_PrevCharCallback)
+        s_PrevCharCallback(window, c);
+}
+
+static void CursorPosCallback(GLFWwindow*, double, double)
+{
+    // 悬停高亮也需要重绘 UI
+    RenderScheduler::Get().NotifyInput();
+}
+
+static void InvalidateCallback(GLFWwindow*)
+{
+    RenderScheduler::Get().Invalidate();
+}
+
+static void FramebufferSizeCallback(GLFWwindow*, int, int)
+{
+    RenderScheduler::Get().Invalidate();
+}
+
+static void FocusCallback(GLFWwindow*, int)
+{
+    RenderScheduler::Get().NotifyInput();
+}
+
+static void InstallSchedulerCallbacks(GLFWwindow* window)
+{
+    s_PrevMouseButtonCallback = glfwSetMouseButtonCallback(window, MouseButtonCallback);
+    s_PrevScrollCallback = glfwSetScrollCallback(window, ScrollCallback);
+    s_PrevKeyCallback = glfwSetKeyCallback(window, KeyCallback);
+    s_PrevCharCallback = glfwSetCharCallback(window, CharCallback);
+    glfwSetCursorPosCallback(window, CursorPosCallback);
+    glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
+    glfwSetWindowRefreshCallback(window, InvalidateCallback);
+    glfwSetWindowFocusCallback(window, FocusCallback);
+}
 
 
 int main(void)
@@ -38,13 +205,20 @@ int main(void)
     {
         std::cout << "glew error!" << std::endl;
     }
+    // 驱动支持时着色器变体在后台线程编译
+    Shader::EnableParallelCompile();
 
     // Setup ImGui binding
+    ImGui::SetAllocatorFunctions(ImGuiAlloc, ImGuiFree);
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     //io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;  // Enable Keyboard Controls
     //io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;   // Enable Gamepad Controls
     ImGui_ImplGlfwGL3_Init(window, true);
+    // 测试场景每次绘制前都会重新绑定自己的状态，ImGui 不需要备份/恢复 GL 状态
+    ImGui_ImplGlfwGL3_SetRestoreGLState(false);
+    // 输入事件报告给按需渲染，需要在 ImGui 安装回调之后
+    InstallSchedulerCallbacks(window);
 
     // Setup style
     ImGui::StyleColorsDark();
@@ -61,23 +235,73 @@ int main(void)
 
     testMenu->ReigsterTest<Test::TestClearColor>("Clear Color");
     testMenu->ReigsterTest<Test::TestTexture2D>("Texture 2D");
+    testMenu->ReigsterTest<Test::TestMesh>("Mesh Import");
+    testMenu->ReigsterTest<Test::TestSpriteOverdraw>("Sprite Overdraw");
+    testMenu->ReigsterTest<Test::TestText>("SDF Text");
+    testMenu->ReigsterTest<Test::TestParticles>("Particles");
+    testMenu->ReigsterTest<Test::TestAllocations>("Allocations");
+    testMenu->ReigsterTest<Test::TestShaderVariants>("Shader Variants");
+    testMenu->ReigsterTest<Test::TestRenderGraph>("Render Graph");
+    testMenu->ReigsterTest<Test::TestTilemap>("Tilemap");
+    testMenu->ReigsterTest<Test::TestOnDemand>("On-Demand Rendering");
+
+    RenderScheduler& scheduler = RenderScheduler::Get();
+    Test::Test* lastTest = nullptr;
+    double lastTime = glfwGetTime();
 
     /* Loop until the user closes the window */
     while (!glfwWindowShouldClose(window))
     {
-        /* Render here */
-        renderer.Clear();
+        /* Poll for and process events */
+        // 按需渲染时没有变化就阻塞在这里
+        scheduler.WaitForEvents();
+
+        double time = glfwGetTime();
+        float deltaTime = (float)(time - lastTime);
+        lastTime = time;
+
+        // OnUpdate 每次醒来都执行，由测试报告动画、定时器和异步结果带来的变化
+        if (currentTest)
+        {
+            MemoryTagScope tag(MemoryTag::Test);
+            currentTest->OnUpdate(deltaTime);
+        }
+        if (currentTest != lastTest)
+        {
+            scheduler.Invalidate();
+            lastTest = currentTest;
+        }
+
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        if (!scheduler.BeginFrame(currentTest ? currentTest->GetRedrawPolicy() : RedrawPolicy::Continuous, width, height))
+            continue;
 
         {
             ImGui_ImplGlfwGL3_NewFrame();
 
+            /* Render here */
+            if (scheduler.ShouldRenderContent())
+            {
+                scheduler.BeginContent();
+                renderer.Clear();
+                if (currentTest)
+                {
+                    MemoryTagScope tag(MemoryTag::Test);
+                    currentTest->OnRender();
+                }
+                scheduler.EndContent();
+            }
+            scheduler.Present();
+
             // ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f    
             ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+            ShowMemoryStats();
+            ShowRenderStats();
 
             if (currentTest)
             {
-                currentTest->OnUpdate(0.f);
-                currentTest->OnRender();
+                MemoryTagScope tag(MemoryTag::Test);
                 ImGui::Begin("Test");
                 if (currentTest != testMenu && ImGui::Button("<-"))
                 {
@@ -94,14 +318,18 @@ int main(void)
 
         /* Swap front and back buffers */
         glfwSwapBuffers(window);
+        scheduler.EndFrame();
 
-        /* Poll for and process events */
-        glfwPollEvents();
+        // 只在真正绘制的帧之后归档统计并切换帧内存：空闲唤醒中 OnUpdate 的分配计入下一个绘制的帧，
+        // 帧内存也不会在没有绘制的情况下被切换回收
+        MemoryTracker::BeginFrame();
+        FrameArena::Get().BeginFrame();
     }
 
     if (currentTest && currentTest != testMenu) delete currentTest;
     delete testMenu;
 
+    scheduler.Shutdown();
     ImGui_ImplGlfwGL3_Shutdown();
     ImGui::DestroyContext();
     glfwTerminate();
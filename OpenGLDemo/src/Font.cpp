@@ -0,0 +1,150 @@
+#include "Font.h"
+
+#include "MappedFile.h"
+
+#include <iostream>
+
+// imgui_draw.cpp 里的实现是 static 的，这里同样以 static 方式编译一份
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imgui/stb_truetype.h"
+
+Font::Font(const std::string& filePath)
+	: m_FilePath(filePath)
+	, m_Info(std::make_unique<stbtt_fontinfo>())
+	, m_Valid(false)
+	, m_HasKerning(false)
+	, m_Scale(0.f)
+	, m_Ascent(0.f)
+	, m_Descent(0.f)
+	, m_LineGap(0.f)
+{
+	// stb_truetype 直接引用字体数据，映射的文件需要和 Font 同生命周期
+	m_File = std::make_unique<MappedFile>(filePath);
+	if (!m_File->IsValid())
+	{
+		std::cout << "Failed to open font: " << filePath << std::endl;
+		return;
+	}
+
+	const unsigned char* data = (const unsigned char*)m_File->GetData();
+	if (!stbtt_InitFont(m_Info.get(), data, stbtt_GetFontOffsetForIndex(data, 0)))
+	{
+		std::cout << "Failed to parse font: " << filePath << std::endl;
+		return;
+	}
+
+	m_Scale = stbtt_ScaleForPixelHeight(m_Info.get(), 1.f);
+	int ascent, descent, lineGap;
+	stbtt_GetFontVMetrics(m_Info.get(), &ascent, &descent, &lineGap);
+	m_Ascent = ascent * m_Scale;
+	m_Descent = descent * m_Scale;
+	m_LineGap = lineGap * m_Scale;
+	m_HasKerning = m_Info->kern != 0;
+
+	for (unsigned int c = 0; c < 128; c++)
+		m_AsciiGlyphs[c] = LoadGlyph(c);
+
+	m_Valid = true;
+}
+
+Font::~Font()
+{
+}
+
+GlyphMetrics Font::LoadGlyph(unsigned int codepoint) const
+{
+	GlyphMetrics glyph;
+	glyph.GlyphIndex = stbtt_FindGlyphIndex(m_Info.get(), (int)codepoint);
+	int advance, leftSideBearing;
+	stbtt_GetGlyphHMetrics(m_Info.get(), glyph.GlyphIndex, &advance, &leftSideBearing);
+	glyph.Advance = advance * m_Scale;
+	return glyph;
+}
+
+const GlyphMetrics& Font::GetGlyph(unsigned int codepoint)
+{
+	if (codepoint < 128)
+		return m_AsciiGlyphs[codepoint];
+
+	auto it = m_Glyphs.find(codepoint);
+	if (it != m_Glyphs.end())
+		return it->second;
+	return m_Glyphs.emplace(codepoint, LoadGlyph(codepoint)).first->second;
+}
+
+float Font::GetKerning(int glyphA, int glyphB)
+{
+	if (!m_HasKerning)
+		return 0.f;
+
+	unsigned long long key = ((unsigned long long)(unsigned int)glyphA << 32) | (unsigned int)glyphB;
+	auto it = m_Kerning.find(key);
+	if (it != m_Kerning.end())
+		return it->second;
+
+	float kerning = stbtt_GetGlyphKernAdvance(m_Info.get(), glyphA, glyphB) * m_Scale;
+	m_Kerning.emplace(key, kerning);
+	return kerning;
+}
+
+unsigned char* Font::GenerateSDF(int glyphIndex, float pixelHeight, int padding, int& width, int& height, int& offsetX, int& offsetY) const
+{
+	// 距离轮廓 padding 像素处衰减到 0，轮廓内外各占一半的取值范围
+	const unsigned char onEdgeValue = 128;
+	float pixelDistanceScale = (float)onEdgeValue / (float)padding;
+	return stbtt_GetGlyphSDF(m_Info.get(), stbtt_ScaleForPixelHeight(m_Info.get(), pixelHeight), glyphIndex, padding,
+		onEdgeValue, pixelDistanceScale, &width, &height, &offsetX, &offsetY);
+}
+
+void Font::FreeSDF(unsigned char* bitmap)
+{
+	stbtt_FreeSDF(bitmap, nullptr);
+}
+
+unsigned int Font::DecodeUTF8(const char*& text, const char* end)
+{
+	const unsigned char* s = (const unsigned char*)text;
+	unsigned int c = s[0];
+	int length = 1;
+	if (c < 0x80)
+		length = 1;
+	else if ((c & 0xE0) == 0xC0)
+	{
+		length = 2;
+		c &= 0x1F;
+	}
+	else if ((c & 0xF0) == 0xE0)
+	{
+		length = 3;
+		c &= 0x0F;
+	}
+	else if ((c & 0xF8) == 0xF0)
+	{
+		length = 4;
+		c &= 0x07;
+	}
+	else
+	{
+		text++;
+		return 0xFFFD;
+	}
+
+	if (end - text < length)
+	{
+		text = end;
+		return 0xFFFD;
+	}
+
+	for (int i = 1; i < length; i++)
+	{
+		if ((s[i] & 0xC0) != 0x80)
+		{
+			text += i;
+			return 0xFFFD;
+		}
+		c = (c << 6) | (s[i] & 0x3F);
+	}
+	text += length;
+	return c;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "PoolAllocator.h"
+
+struct stbtt_fontinfo;
+class MappedFile;
+
+// 字形度量，单位为“字体像素高度 = 1”，使用时乘以字号
+struct GlyphMetrics
+{
+	int GlyphIndex = 0;
+	float Advance = 0.f;
+};
+
+// TrueType 字体：字符 -> 字形映射、度量和字距都会缓存，stb_truetype 的查询不便宜
+class Font
+{
+public:
+	Font(const std::string& filePath);
+	~Font();
+
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
+
+	inline bool IsValid() const { return m_Valid; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+
+	inline float GetAscent() const { return m_Ascent; }
+	inline float GetDescent() const { return m_Descent; }
+	inline float GetLineHeight() const { return m_Ascent - m_Descent + m_LineGap; }
+
+	const GlyphMetrics& GetGlyph(unsigned int codepoint);
+	float GetKerning(int glyphA, int glyphB);
+
+	// 生成单通道 SDF 位图，轮廓处的值为 128；空字形（如空格）返回 nullptr。用 FreeSDF 释放
+	unsigned char* GenerateSDF(int glyphIndex, float pixelHeight, int padding, int& width, int& height, int& offsetX, int& offsetY) const;
+	static void FreeSDF(unsigned char* bitmap);
+
+	// 解码一个 UTF-8 字符并前移 text，非法字节返回 U+FFFD
+	static unsigned int DecodeUTF8(const char*& text, const char* end);
+
+private:
+	GlyphMetrics LoadGlyph(unsigned int codepoint) const;
+
+private:
+	std::string m_FilePath;
+	std::unique_ptr<MappedFile> m_File;
+	std::unique_ptr<stbtt_fontinfo> m_Info;
+	bool m_Valid;
+	bool m_HasKerning;
+	float m_Scale;
+	float m_Ascent, m_Descent, m_LineGap;
+
+	// ASCII 直接查表，其余字符走哈希表
+	GlyphMetrics m_AsciiGlyphs[128];
+	std::unordered_map<unsigned int, GlyphMetrics, std::hash<unsigned int>, std::equal_to<unsigned int>, PoolAllocator<std::pair<const unsigned int, GlyphMetrics>>> m_Glyphs;
+	std::unordered_map<unsigned long long, float, std::hash<unsigned long long>, std::equal_to<unsigned long long>, PoolAllocator<std::pair<const unsigned long long, float>>> m_Kerning;
+};
@@ -0,0 +1,88 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <new>
+
+namespace {
+
+	const size_t FrameArenaCapacity = 8 * 1024 * 1024;
+
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+}
+
+LinearArena::LinearArena(size_t capacity)
+	: m_Buffer((char*)::operator new(capacity))
+	, m_Capacity(capacity)
+	, m_Offset(0)
+	, m_Peak(0)
+	, m_OverflowReported(false)
+{
+}
+
+LinearArena::~LinearArena()
+{
+	Reset();
+	::operator delete(m_Buffer);
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+	// 按绝对地址对齐，缓冲起始地址只保证 16 字节对齐
+	uintptr_t base = (uintptr_t)m_Buffer;
+	size_t offset = AlignUp(base + m_Offset, alignment) - base;
+	if (offset + size <= m_Capacity)
+	{
+		m_Offset = offset + size;
+		m_Peak = std::max(m_Peak, m_Offset);
+		return m_Buffer + offset;
+	}
+
+	if (!m_OverflowReported)
+	{
+		std::cout << "Warring:: frame arena overflow (" << m_Capacity << " bytes), falling back to heap" << std::endl;
+		m_OverflowReported = true;
+	}
+	// operator new 不保证超过 16 字节的对齐，多申请 alignment - 1 字节再手动对齐，记录原始指针用于释放
+	char* pointer = (char*)::operator new(size + alignment - 1);
+	m_Overflow.push_back(pointer);
+	return pointer + (AlignUp((uintptr_t)pointer, alignment) - (uintptr_t)pointer);
+}
+
+void LinearArena::Reset()
+{
+	for (void* pointer : m_Overflow)
+		::operator delete(pointer);
+	m_Overflow.clear();
+	m_Offset = 0;
+}
+
+FrameArena& FrameArena::Get()
+{
+	static FrameArena arena(FrameArenaCapacity);
+	return arena;
+}
+
+FrameArena::FrameArena(size_t capacity)
+	: m_Current(0)
+{
+	// 随程序存在，不释放
+	m_Arenas[0] = new LinearArena(capacity);
+	m_Arenas[1] = new LinearArena(capacity);
+}
+
+void FrameArena::BeginFrame()
+{
+	m_Current = 1 - m_Current;
+	m_Arenas[m_Current]->Reset();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	return m_Arenas[m_Current]->Allocate(size, alignment);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// 线性（bump）分配器：只前移指针，Reset 时整体释放；单个分配不能释放
+class LinearArena
+{
+public:
+	LinearArena(size_t capacity);
+	~LinearArena();
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	// 容量不足时退回到堆分配（计入 Overflow），在 Reset 时统一释放
+	void* Allocate(size_t size, size_t alignment = 16);
+	void Reset();
+
+	inline size_t GetUsed() const { return m_Offset; }
+	inline size_t GetPeak() const { return m_Peak; }
+	inline size_t GetCapacity() const { return m_Capacity; }
+	inline unsigned int GetOverflowCount() const { return (unsigned int)m_Overflow.size(); }
+
+private:
+	char* m_Buffer;
+	size_t m_Capacity;
+	size_t m_Offset;
+	size_t m_Peak;
+	std::vector<void*> m_Overflow;
+	bool m_OverflowReported;    // 只在第一次溢出时输出警告，之后看 GetOverflowCount
+};
+
+// 每帧的临时内存：两个 LinearArena 轮流使用，第 N 帧分配的内存在第 N + 1 帧仍然有效，
+// 供 GPU 还在读取的数据（如映射缓冲的暂存）使用
+class FrameArena
+{
+public:
+	static FrameArena& Get();
+
+	// 在交换缓冲后调用：切换到另一块并清空它
+	void BeginFrame();
+	void* Allocate(size_t size, size_t alignment = 16);
+
+	template<typename T>
+	T* Allocate(size_t count)
+	{
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+	inline const LinearArena& GetCurrent() const { return *m_Arenas[m_Current]; }
+
+private:
+	FrameArena(size_t capacity);
+
+private:
+	LinearArena* m_Arenas[2];
+	unsigned int m_Current;
+};
+
+// 让 STL 容器使用帧内存，deallocate 不做任何事；容器不能跨越两帧以上
+template<typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator() {}
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t count) { return FrameArena::Get().Allocate<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>&) const { return true; }
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>&) const { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
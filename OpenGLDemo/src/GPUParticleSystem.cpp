@@ -0,0 +1,160 @@
+#include "GPUParticleSystem.h"
+
+#include "Renderer.h"
+#include "Shader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+	// 交错格式：position(2) velocity(2) life maxLife
+	struct GPUParticle
+	{
+		float Position[2];
+		float Velocity[2];
+		float Life;
+		float MaxLife;
+	};
+
+	void SetFloatAttribute(unsigned int index, int count, unsigned int stride, size_t offset, unsigned int divisor)
+	{
+		GLCALL(glEnableVertexAttribArray(index));
+		GLCALL(glVertexAttribPointer(index, count, GL_FLOAT, GL_FALSE, stride, (const void*)(uintptr_t)offset));
+		GLCALL(glVertexAttribDivisor(index, divisor));
+	}
+
+}
+
+GPUParticleSystem::GPUParticleSystem(unsigned int capacity)
+	: m_Capacity(capacity)
+	, m_Current(0)
+	, m_Frame(0)
+	, m_Time(0.f)
+	, m_SimulateMilliseconds(0.0)
+{
+	// 初始 life 为负数表示还要等待多久才第一次发射，把发射时间错开，避免所有粒子同时出现
+	std::vector<GPUParticle> particles(capacity);
+	std::mt19937 rng(12777);
+	std::uniform_real_distribution<float> delay(-2.f, 0.f);
+	for (GPUParticle& particle : particles)
+	{
+		particle = GPUParticle();
+		particle.Life = delay(rng);
+		particle.MaxLife = 1.f;
+	}
+
+	float corners[] = {
+		-0.5f, -0.5f,
+		 0.5f, -0.5f,
+		-0.5f,  0.5f,
+		 0.5f,  0.5f,
+	};
+
+	GLCALL(glGenBuffers(1, &m_QuadBuffer));
+	GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_QuadBuffer));
+	GLCALL(glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW));
+
+	GLCALL(glGenBuffers(2, m_Buffers));
+	GLCALL(glGenVertexArrays(2, m_UpdateVAOs));
+	GLCALL(glGenVertexArrays(2, m_RenderVAOs));
+	const unsigned int stride = sizeof(GPUParticle);
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_Buffers[i]));
+		GLCALL(glBufferData(GL_ARRAY_BUFFER, capacity * stride, particles.data(), GL_DYNAMIC_COPY));
+
+		// 模拟：每个粒子一个点
+		GLCALL(glBindVertexArray(m_UpdateVAOs[i]));
+		SetFloatAttribute(0, 2, stride, offsetof(GPUParticle, Position), 0);
+		SetFloatAttribute(1, 2, stride, offsetof(GPUParticle, Velocity), 0);
+		SetFloatAttribute(2, 1, stride, offsetof(GPUParticle, Life), 0);
+		SetFloatAttribute(3, 1, stride, offsetof(GPUParticle, MaxLife), 0);
+
+		// 绘制：与 CPU 模式共用 Particle.shader 的属性布局
+		GLCALL(glBindVertexArray(m_RenderVAOs[i]));
+		GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_QuadBuffer));
+		SetFloatAttribute(0, 2, 2 * sizeof(float), 0, 0);
+		GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_Buffers[i]));
+		SetFloatAttribute(1, 1, stride, offsetof(GPUParticle, Position), 1);
+		SetFloatAttribute(2, 1, stride, offsetof(GPUParticle, Position) + sizeof(float), 1);
+		SetFloatAttribute(3, 1, stride, offsetof(GPUParticle, Life), 1);
+		SetFloatAttribute(4, 1, stride, offsetof(GPUParticle, MaxLife), 1);
+	}
+	GLCALL(glBindVertexArray(0));
+
+	m_UpdateShader = std::make_unique<Shader>("res/shaders/ParticleUpdate.shader",
+		std::vector<std::string>{ "tf_Position", "tf_Velocity", "tf_Life", "tf_MaxLife" });
+	m_RenderShader = std::make_unique<Shader>("res/shaders/Particle.shader");
+
+	glGenQueries(2, m_TimerQueries);
+}
+
+GPUParticleSystem::~GPUParticleSystem()
+{
+	glDeleteQueries(2, m_TimerQueries);
+	glDeleteVertexArrays(2, m_UpdateVAOs);
+	glDeleteVertexArrays(2, m_RenderVAOs);
+	glDeleteBuffers(2, m_Buffers);
+	glDeleteBuffers(1, &m_QuadBuffer);
+}
+
+void GPUParticleSystem::Update(float deltaTime, const ParticleEmitterSettings& settings)
+{
+	m_Time += deltaTime;
+
+	// 读取上一帧的计时，不等待
+	if (m_Frame > 0)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(m_TimerQueries[(m_Frame + 1) % 2], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(m_TimerQueries[(m_Frame + 1) % 2], GL_QUERY_RESULT, &elapsed);
+			m_SimulateMilliseconds = elapsed / 1000000.0;
+		}
+	}
+	glBeginQuery(GL_TIME_ELAPSED, m_TimerQueries[m_Frame % 2]);
+
+	unsigned int next = 1 - m_Current;
+
+	m_UpdateShader->Bind();
+	m_UpdateShader->SetUniform1f("u_DeltaTime", deltaTime);
+	m_UpdateShader->SetUniform1i("u_Frame", (int)m_Frame);
+	m_UpdateShader->SetUniform4f("u_Emitter", settings.Position.x, settings.Position.y, settings.Direction, settings.Spread);
+	m_UpdateShader->SetUniform4f("u_Motion", settings.Speed, settings.Lifetime, settings.Gravity, settings.Drag);
+
+	// 只做顶点处理，不光栅化
+	GLCALL(glEnable(GL_RASTERIZER_DISCARD));
+	GLCALL(glBindVertexArray(m_UpdateVAOs[m_Current]));
+	GLCALL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_Buffers[next]));
+	GLCALL(glBeginTransformFeedback(GL_POINTS));
+	GLCALL(glDrawArrays(GL_POINTS, 0, m_Capacity));
+	GLCALL(glEndTransformFeedback());
+	GLCALL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+	GLCALL(glBindVertexArray(0));
+	GLCALL(glDisable(GL_RASTERIZER_DISCARD));
+
+	glEndQuery(GL_TIME_ELAPSED);
+
+	m_Current = next;
+	m_Frame++;
+}
+
+void GPUParticleSystem::Render(const glm::mat4& viewProjection, const ParticleEmitterSettings& settings)
+{
+	GLCALL(glEnable(GL_BLEND));
+	GLCALL(glBlendFunc(GL_ONE, GL_ONE));
+
+	m_RenderShader->Bind();
+	m_RenderShader->SetUniformMat4f("u_MVP", viewProjection);
+	m_RenderShader->SetUniform1f("u_Size", settings.Size);
+	GLCALL(glBindVertexArray(m_RenderVAOs[m_Current]));
+	GLCALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_Capacity));
+	GLCALL(glBindVertexArray(0));
+
+	GLCALL(glDisable(GL_BLEND));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include "ParticleSystem.h"
+
+// GPU 模拟的粒子系统：两个缓冲通过 transform feedback 来回写（ping-pong），数据不回到 CPU。
+// 粒子数固定为容量，死亡的粒子在着色器中直接在发射器处重生
+class GPUParticleSystem
+{
+public:
+	GPUParticleSystem(unsigned int capacity);
+	~GPUParticleSystem();
+
+	void Update(float deltaTime, const ParticleEmitterSettings& settings);
+	void Render(const glm::mat4& viewProjection, const ParticleEmitterSettings& settings);
+
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+	// 上一帧模拟（transform feedback）的 GPU 耗时
+	inline double GetSimulateMilliseconds() const { return m_SimulateMilliseconds; }
+
+private:
+	unsigned int m_Capacity;
+	unsigned int m_Buffers[2];
+	unsigned int m_UpdateVAOs[2];   // 从 m_Buffers[i] 读取的模拟 VAO
+	unsigned int m_RenderVAOs[2];   // 以 m_Buffers[i] 作为实例数据的绘制 VAO
+	unsigned int m_QuadBuffer;
+	unsigned int m_Current;         // 保存最新数据的缓冲
+	unsigned int m_Frame;
+	float m_Time;
+
+	std::unique_ptr<Shader> m_UpdateShader;
+	std::unique_ptr<Shader> m_RenderShader;
+
+	unsigned int m_TimerQueries[2];
+	double m_SimulateMilliseconds;
+};
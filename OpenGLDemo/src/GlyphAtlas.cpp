@@ -0,0 +1,174 @@
+#include "GlyphAtlas.h"
+
+#include "Renderer.h"
+#include "Font.h"
+
+#include <chrono>
+
+namespace {
+
+	// 字形之间留 1 像素空隙，避免线性过滤采到相邻字形
+	const int GlyphSpacing = 1;
+	// 行高按 4 像素对齐，相近高度的字形可以共用一行
+	const int ShelfAlignment = 4;
+
+}
+
+GlyphAtlas::GlyphAtlas(Font& font, unsigned int size, float sdfPixelHeight, int padding)
+	: m_Font(font)
+	, m_RendererID(0)
+	, m_Size(size)
+	, m_SDFPixelHeight(sdfPixelHeight)
+	, m_Padding(padding)
+	, m_NextShelfY(0)
+	, m_Batch(1)
+{
+	std::vector<unsigned char> empty(size * size, 0);
+	GLCALL(glGenTextures(1, &m_RendererID));
+	GLCALL(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	// 单通道纹理按灰度读取，方便在 ImGui 里直接查看图集
+	GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+	GLCALL(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+	GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, empty.data()));
+	GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	GLCALL(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	GLCALL(glDeleteTextures(1, &m_RendererID));
+}
+
+void GlyphAtlas::BeginBatch()
+{
+	m_Batch++;
+}
+
+void GlyphAtlas::Bind(unsigned int slot) const
+{
+	GLCALL(glActiveTexture(GL_TEXTURE0 + slot));
+	GLCALL(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+}
+
+const AtlasGlyph* GlyphAtlas::GetGlyph(int glyphIndex)
+{
+	auto it = m_Glyphs.find(glyphIndex);
+	if (it != m_Glyphs.end())
+	{
+		AtlasGlyph& glyph = it->second;
+		glyph.LastUsed = m_Batch;
+		if (glyph.Shelf >= 0)
+			m_Shelves[glyph.Shelf].LastUsed = m_Batch;
+		return &glyph;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	int width = 0, height = 0, offsetX = 0, offsetY = 0;
+	unsigned char* bitmap = m_Font.GenerateSDF(glyphIndex, m_SDFPixelHeight, m_Padding, width, height, offsetX, offsetY);
+
+	AtlasGlyph glyph;
+	glyph.LastUsed = m_Batch;
+	if (bitmap)
+	{
+		int shelfIndex = AllocateShelf(width + GlyphSpacing, height + GlyphSpacing);
+		if (shelfIndex < 0)
+		{
+			Font::FreeSDF(bitmap);
+			return nullptr;
+		}
+
+		Shelf& shelf = m_Shelves[shelfIndex];
+		int x = shelf.CursorX;
+		shelf.CursorX += width + GlyphSpacing;
+		shelf.LastUsed = m_Batch;
+		shelf.Glyphs.push_back(glyphIndex);
+
+		GLCALL(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+		GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, x, shelf.Y, width, height, GL_RED, GL_UNSIGNED_BYTE, bitmap));
+		GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+		Font::FreeSDF(bitmap);
+
+		float invSize = 1.f / (float)m_Size;
+		float invPixelHeight = 1.f / m_SDFPixelHeight;
+		glyph.U0 = x * invSize;
+		glyph.V0 = shelf.Y * invSize;
+		glyph.U1 = (x + width) * invSize;
+		glyph.V1 = (shelf.Y + height) * invSize;
+		glyph.OffsetX = offsetX * invPixelHeight;
+		glyph.OffsetY = offsetY * invPixelHeight;
+		glyph.Width = width * invPixelHeight;
+		glyph.Height = height * invPixelHeight;
+		glyph.Empty = false;
+		glyph.Shelf = shelfIndex;
+	}
+
+	m_Stats.Rasterized++;
+	m_Stats.RasterizeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	AtlasGlyph& resident = m_Glyphs.emplace(glyphIndex, glyph).first->second;
+	m_Stats.ResidentGlyphs = (unsigned int)m_Glyphs.size();
+	return &resident;
+}
+
+int GlyphAtlas::AllocateShelf(int width, int height)
+{
+	if (width > (int)m_Size || height > (int)m_Size)
+		return -1;
+
+	// 1. 已有的行中高度最合适的一行（不浪费超过一半的高度）
+	int best = -1;
+	for (int i = 0; i < (int)m_Shelves.size(); i++)
+	{
+		const Shelf& shelf = m_Shelves[i];
+		if (shelf.Height < height || shelf.Height > height * 3 / 2 + ShelfAlignment)
+			continue;
+		if (shelf.CursorX + width > (int)m_Size)
+			continue;
+		if (best < 0 || shelf.Height < m_Shelves[best].Height)
+			best = i;
+	}
+	if (best >= 0)
+		return best;
+
+	// 2. 图集底部还有空间，开一行新的
+	int shelfHeight = (height + ShelfAlignment - 1) / ShelfAlignment * ShelfAlignment;
+	if (m_NextShelfY + shelfHeight <= (int)m_Size)
+	{
+		m_Shelves.push_back({ m_NextShelfY, shelfHeight, 0, m_Batch, {} });
+		m_NextShelfY += shelfHeight;
+		m_Stats.ShelfCount = (unsigned int)m_Shelves.size();
+		return (int)m_Shelves.size() - 1;
+	}
+
+	// 3. 回收最久未使用、且不属于当前批次的一行
+	int victim = -1;
+	for (int i = 0; i < (int)m_Shelves.size(); i++)
+	{
+		const Shelf& shelf = m_Shelves[i];
+		if (shelf.Height < height || shelf.LastUsed >= m_Batch)
+			continue;
+		if (victim < 0 || shelf.LastUsed < m_Shelves[victim].LastUsed)
+			victim = i;
+	}
+	if (victim >= 0)
+		EvictShelf(victim);
+	return victim;
+}
+
+void GlyphAtlas::EvictShelf(int shelfIndex)
+{
+	Shelf& shelf = m_Shelves[shelfIndex];
+	for (int glyphIndex : shelf.Glyphs)
+		m_Glyphs.erase(glyphIndex);
+
+	m_Stats.Evictions += (unsigned int)shelf.Glyphs.size();
+	m_Stats.ResidentGlyphs = (unsigned int)m_Glyphs.size();
+	shelf.Glyphs.clear();
+	shelf.CursorX = 0;
+}
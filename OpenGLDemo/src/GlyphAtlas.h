@@ -0,0 +1,75 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "PoolAllocator.h"
+
+class Font;
+
+// 已放入图集的字形，坐标单位同 GlyphMetrics（字号为 1）
+struct AtlasGlyph
+{
+	float U0 = 0.f, V0 = 0.f, U1 = 0.f, V1 = 0.f;
+	float OffsetX = 0.f, OffsetY = 0.f;    // 左上角相对笔位置的偏移，y 向下
+	float Width = 0.f, Height = 0.f;
+	bool Empty = true;                      // 空字形不占图集空间
+	int Shelf = -1;
+	unsigned int LastUsed = 0;
+};
+
+struct GlyphAtlasStats
+{
+	unsigned int ResidentGlyphs = 0;
+	unsigned int Rasterized = 0;
+	unsigned int Evictions = 0;      // 被整行回收的字形数
+	unsigned int ShelfCount = 0;
+	double RasterizeMilliseconds = 0.0;
+};
+
+// 单个字体的 SDF 字形图集：按行（shelf）动态打包，空间不足时回收最久未使用的一行
+class GlyphAtlas
+{
+public:
+	GlyphAtlas(Font& font, unsigned int size = 1024, float sdfPixelHeight = 48.f, int padding = 6);
+	~GlyphAtlas();
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+	// 返回 nullptr 表示图集已满且当前批次用到的行都不能回收，调用方需要先提交批次再调用 BeginBatch
+	const AtlasGlyph* GetGlyph(int glyphIndex);
+	// 开始新的批次：之前批次用到的字形都可以被回收
+	void BeginBatch();
+
+	void Bind(unsigned int slot = 0) const;
+
+	inline Font& GetFont() const { return m_Font; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetSize() const { return m_Size; }
+	inline const GlyphAtlasStats& GetStats() const { return m_Stats; }
+
+private:
+	struct Shelf
+	{
+		int Y, Height, CursorX;
+		unsigned int LastUsed;
+		std::vector<int> Glyphs;
+	};
+
+	int AllocateShelf(int width, int height);
+	void EvictShelf(int shelfIndex);
+
+private:
+	Font& m_Font;
+	unsigned int m_RendererID;
+	unsigned int m_Size;
+	float m_SDFPixelHeight;
+	int m_Padding;
+
+	// 回收和重新加载字形时节点来自池，不访问堆
+	std::unordered_map<int, AtlasGlyph, std::hash<int>, std::equal_to<int>, PoolAllocator<std::pair<const int, AtlasGlyph>>> m_Glyphs;
+	std::vector<Shelf> m_Shelves;
+	int m_NextShelfY;
+	unsigned int m_Batch;
+	GlyphAtlasStats m_Stats;
+};
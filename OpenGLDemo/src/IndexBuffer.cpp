@@ -5,12 +5,22 @@
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
     : m_Count(count)
+    , m_Type(GL_UNSIGNED_INT)
 {
     GLCALL(glGenBuffers(1, &m_RendererID));
     GLCALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
     GLCALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
 }
 
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count)
+    : m_Count(count)
+    , m_Type(GL_UNSIGNED_SHORT)
+{
+    GLCALL(glGenBuffers(1, &m_RendererID));
+    GLCALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLCALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), data, GL_STATIC_DRAW));
+}
+
 IndexBuffer::~IndexBuffer()
 {
     glDeleteBuffers(1, &m_RendererID);
@@ -5,15 +5,18 @@ class IndexBuffer
 {
 public:
 	IndexBuffer(const unsigned int* data, unsigned int count);
+	IndexBuffer(const unsigned short* data, unsigned int count);
 	~IndexBuffer();
 
 	void Bind() const;
 	void UnBind()  const;
 
 	inline unsigned int GetCount() const { return m_Count; }
+	// GL_UNSIGNED_INT 或 GL_UNSIGNED_SHORT
+	inline unsigned int GetType() const { return m_Type; }
 
 private:
 	unsigned int m_RendererID;
 	unsigned int m_Count;
+	unsigned int m_Type;
 };
-
@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filePath)
+	: m_Data(nullptr)
+	, m_Size(0)
+	, m_FileHandle(INVALID_HANDLE_VALUE)
+	, m_MappingHandle(nullptr)
+{
+	m_FileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_FileHandle == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "Warring:: failed to open " << filePath << std::endl;
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_FileHandle, &size) || size.QuadPart == 0)
+		return;
+
+	m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_MappingHandle)
+		return;
+
+	m_Data = (const char*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (m_Data)
+		m_Size = (size_t)size.QuadPart;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_MappingHandle)
+		CloseHandle(m_MappingHandle);
+	if (m_FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(m_FileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filePath)
+	: m_Data(nullptr)
+	, m_Size(0)
+	, m_FileDescriptor(-1)
+{
+	m_FileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (m_FileDescriptor < 0)
+	{
+		std::cout << "Warring:: failed to open " << filePath << std::endl;
+		return;
+	}
+
+	struct stat st;
+	if (fstat(m_FileDescriptor, &st) != 0 || st.st_size == 0)
+		return;
+
+	void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+	if (data == MAP_FAILED)
+		return;
+
+	madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+	m_Data = (const char*)data;
+	m_Size = (size_t)st.st_size;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+	if (m_FileDescriptor >= 0)
+		close(m_FileDescriptor);
+}
+
+#endif
@@ -0,0 +1,169 @@
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+	const int TagCount = (int)MemoryTag::Count;
+
+	// 头部 16 字节，保证返回的指针仍然满足 malloc 的对齐
+	struct AllocationHeader
+	{
+		size_t Size;
+		size_t Tag;
+	};
+	const size_t HeaderSize = 16;
+	static_assert(sizeof(AllocationHeader) <= HeaderSize, "allocation header too large");
+
+	// 都是零初始化的全局原子量，在任何静态构造函数调用 new 之前就可用
+	std::atomic<unsigned long long> s_FrameAllocations[TagCount];
+	std::atomic<unsigned long long> s_FrameBytes[TagCount];
+	std::atomic<long long> s_LiveAllocations[TagCount];
+	std::atomic<long long> s_LiveBytes[TagCount];
+	std::atomic<unsigned long long> s_TotalAllocations;
+
+	MemoryTagStats s_LastFrame[TagCount];
+
+	thread_local MemoryTag s_CurrentTag = MemoryTag::Untagged;
+
+	const char* TagNames[TagCount] = {
+		"Untagged", "Application", "Test", "Renderer", "Shader", "Text", "Particles", "ImGui",
+	};
+
+}
+
+void* MemoryTracker::Allocate(size_t size)
+{
+	AllocationHeader* header = (AllocationHeader*)std::malloc(size + HeaderSize);
+	if (!header)
+		return nullptr;
+
+	int tag = (int)s_CurrentTag;
+	header->Size = size;
+	header->Tag = (size_t)tag;
+
+	s_FrameAllocations[tag].fetch_add(1, std::memory_order_relaxed);
+	s_FrameBytes[tag].fetch_add(size, std::memory_order_relaxed);
+	s_LiveAllocations[tag].fetch_add(1, std::memory_order_relaxed);
+	s_LiveBytes[tag].fetch_add((long long)size, std::memory_order_relaxed);
+	s_TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	return (char*)header + HeaderSize;
+}
+
+void MemoryTracker::Free(void* pointer)
+{
+	if (!pointer)
+		return;
+
+	AllocationHeader* header = (AllocationHeader*)((char*)pointer - HeaderSize);
+	int tag = (int)header->Tag;
+	s_LiveAllocations[tag].fetch_sub(1, std::memory_order_relaxed);
+	s_LiveBytes[tag].fetch_sub((long long)header->Size, std::memory_order_relaxed);
+	std::free(header);
+}
+
+void MemoryTracker::BeginFrame()
+{
+	for (int i = 0; i < TagCount; i++)
+	{
+		s_LastFrame[i].Allocations = s_FrameAllocations[i].exchange(0, std::memory_order_relaxed);
+		s_LastFrame[i].Bytes = s_FrameBytes[i].exchange(0, std::memory_order_relaxed);
+		s_LastFrame[i].LiveAllocations = s_LiveAllocations[i].load(std::memory_order_relaxed);
+		s_LastFrame[i].LiveBytes = s_LiveBytes[i].load(std::memory_order_relaxed);
+	}
+}
+
+MemoryTagStats MemoryTracker::GetFrameStats(MemoryTag tag)
+{
+	return s_LastFrame[(int)tag];
+}
+
+MemoryTagStats MemoryTracker::GetFrameTotal()
+{
+	MemoryTagStats total;
+	for (int i = 0; i < TagCount; i++)
+	{
+		total.Allocations += s_LastFrame[i].Allocations;
+		total.Bytes += s_LastFrame[i].Bytes;
+		total.LiveAllocations += s_LastFrame[i].LiveAllocations;
+		total.LiveBytes += s_LastFrame[i].LiveBytes;
+	}
+	return total;
+}
+
+unsigned long long MemoryTracker::GetTotalAllocations()
+{
+	return s_TotalAllocations.load(std::memory_order_relaxed);
+}
+
+MemoryTag MemoryTracker::GetCurrentTag()
+{
+	return s_CurrentTag;
+}
+
+void MemoryTracker::SetCurrentTag(MemoryTag tag)
+{
+	s_CurrentTag = tag;
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+	return TagNames[(int)tag];
+}
+
+// 替换全局分配函数，整个程序（包括 STL 容器）的堆分配都会经过 MemoryTracker
+void* operator new(size_t size)
+{
+	void* pointer = MemoryTracker::Allocate(size);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return MemoryTracker::Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return MemoryTracker::Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::Free(pointer);
+}
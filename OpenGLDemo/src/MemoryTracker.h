@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+// 分配来源，通过 MemoryTagScope 设置当前线程的标签
+enum class MemoryTag
+{
+	Untagged,
+	Application,
+	Test,
+	Renderer,
+	Shader,
+	Text,
+	Particles,
+	ImGui,
+	Count
+};
+
+struct MemoryTagStats
+{
+	unsigned long long Allocations = 0;
+	unsigned long long Bytes = 0;
+	long long LiveAllocations = 0;
+	long long LiveBytes = 0;
+};
+
+// 全局 operator new/delete 被替换为带计数的版本：每个分配前面有 16 字节的头记录大小和标签，
+// 每帧统计各标签的分配次数和字节数
+class MemoryTracker
+{
+public:
+	static void* Allocate(size_t size);
+	static void Free(void* pointer);
+
+	// 在帧开始时调用：保存上一帧的统计并清零
+	static void BeginFrame();
+
+	// 上一个完整帧的统计（Allocations/Bytes 为该帧内的数量，Live* 为帧结束时的存活量）
+	static MemoryTagStats GetFrameStats(MemoryTag tag);
+	static MemoryTagStats GetFrameTotal();
+	// 程序启动以来的分配总次数，用于统计一段代码内的分配：前后相减
+	static unsigned long long GetTotalAllocations();
+
+	static MemoryTag GetCurrentTag();
+	static void SetCurrentTag(MemoryTag tag);
+	static const char* GetTagName(MemoryTag tag);
+};
+
+class MemoryTagScope
+{
+public:
+	MemoryTagScope(MemoryTag tag)
+		: m_Previous(MemoryTracker::GetCurrentTag())
+	{
+		MemoryTracker::SetCurrentTag(tag);
+	}
+
+	~MemoryTagScope()
+	{
+		MemoryTracker::SetCurrentTag(m_Previous);
+	}
+
+private:
+	MemoryTag m_Previous;
+};
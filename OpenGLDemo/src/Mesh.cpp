@@ -0,0 +1,100 @@
+#include "Mesh.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "MeshImporter.h"
+#include "MappedFile.h"
+
+#include <iostream>
+
+Mesh::Mesh(const void* vertices, unsigned int size, const VertexBufferLayout& layout, const void* indices, unsigned int count, unsigned int indexType)
+	: m_VertexCount(layout.GetStride() > 0 ? size / layout.GetStride() : 0)
+	, m_VertexDataSize(size)
+	, m_IndexDataSize(count * (indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int)))
+	, m_DequantizeMatrix(1.f)
+{
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(vertices, size);
+	m_VAO->AddBuffer(*m_VBO, layout);
+	if (indexType == GL_UNSIGNED_SHORT)
+		m_IBO = std::make_unique<IndexBuffer>((const unsigned short*)indices, count);
+	else
+		m_IBO = std::make_unique<IndexBuffer>((const unsigned int*)indices, count);
+	m_VAO->UnBind();
+}
+
+Mesh::Mesh(const MeshData& data)
+	: Mesh(data.VertexData.data(), (unsigned int)data.VertexData.size(), data.Layout,
+		data.IndexType == GL_UNSIGNED_SHORT ? (const void*)MeshImporter::NarrowIndices(data.Indices).data() : (const void*)data.Indices.data(),
+		(unsigned int)data.Indices.size(), data.IndexType)
+{
+	SetDequantize(data.PositionScale, data.PositionOffset);
+}
+
+Mesh::~Mesh()
+{
+}
+
+void Mesh::SetDequantize(const float* scale, const float* offset)
+{
+	m_DequantizeMatrix = glm::mat4(1.f);
+	m_DequantizeMatrix[0][0] = scale[0];
+	m_DequantizeMatrix[1][1] = scale[1];
+	m_DequantizeMatrix[2][2] = scale[2];
+	m_DequantizeMatrix[3] = glm::vec4(offset[0], offset[1], offset[2], 1.f);
+}
+
+std::unique_ptr<Mesh> Mesh::LoadCooked(const std::string& filePath)
+{
+	MappedFile file(filePath);
+	if (!file.IsValid() || file.GetSize() < sizeof(CookedMeshHeader))
+	{
+		std::cout << "Failed to load cooked mesh: " << filePath << std::endl;
+		return nullptr;
+	}
+
+	const CookedMeshHeader& header = *(const CookedMeshHeader*)file.GetData();
+	if (!MeshImporter::IsCookedHeaderValid(header, file.GetSize()))
+	{
+		std::cout << "Failed to load cooked mesh: " << filePath << " is not a valid cooked mesh" << std::endl;
+		return nullptr;
+	}
+
+	// 每个元素占用一个顶点属性槽位
+	GLint maxAttributes = 16;
+	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributes);
+	if (header.ElementCount > (unsigned int)maxAttributes)
+	{
+		std::cout << "Failed to load cooked mesh: " << filePath << " has " << header.ElementCount << " vertex elements (max " << maxAttributes << ")" << std::endl;
+		return nullptr;
+	}
+	if (!MeshImporter::IsCookedIndexDataValid(header, file.GetData()))
+	{
+		std::cout << "Failed to load cooked mesh: " << filePath << " has indices out of the vertex range" << std::endl;
+		return nullptr;
+	}
+
+	VertexBufferLayout layout;
+	const CookedMeshElement* elements = (const CookedMeshElement*)(file.GetData() + sizeof(CookedMeshHeader));
+	for (unsigned int i = 0; i < header.ElementCount; i++)
+	{
+		if (!MeshImporter::IsCookedElementValid(elements[i]))
+		{
+			std::cout << "Failed to load cooked mesh: " << filePath << " has an unknown vertex element type" << std::endl;
+			return nullptr;
+		}
+		layout.Push(VertexBufferElement(elements[i].Type, elements[i].Count, (unsigned char)elements[i].Normalized));
+	}
+
+	if (layout.GetStride() != header.Stride)
+	{
+		std::cout << "Failed to load cooked mesh: " << filePath << " has a mismatched vertex layout" << std::endl;
+		return nullptr;
+	}
+
+	std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>(file.GetData() + header.VertexDataOffset, header.VertexDataSize, layout,
+		file.GetData() + header.IndexDataOffset, header.IndexCount, header.IndexType);
+	mesh->SetDequantize(header.PositionScale, header.PositionOffset);
+	return mesh;
+}
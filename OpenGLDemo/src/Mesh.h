@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "glm/glm.hpp"
+
+class VertexArray;
+class VertexBuffer;
+class VertexBufferLayout;
+class IndexBuffer;
+struct MeshData;
+
+// GPU 端网格：一个 VAO + 顶点缓冲 + 索引缓冲
+class Mesh
+{
+public:
+	// indexType 为 GL_UNSIGNED_INT 或 GL_UNSIGNED_SHORT
+	Mesh(const void* vertices, unsigned int size, const VertexBufferLayout& layout, const void* indices, unsigned int count, unsigned int indexType);
+	Mesh(const MeshData& data);
+	~Mesh();
+
+	// 从烘焙的二进制网格文件加载：映射文件后直接上传，不做任何解析
+	static std::unique_ptr<Mesh> LoadCooked(const std::string& filePath);
+
+	inline const VertexArray* GetVertexArray() const { return m_VAO.get(); }
+	inline const IndexBuffer* GetIndexBuffer() const { return m_IBO.get(); }
+	inline unsigned int GetVertexCount() const { return m_VertexCount; }
+	inline unsigned int GetVertexDataSize() const { return m_VertexDataSize; }
+	inline unsigned int GetIndexDataSize() const { return m_IndexDataSize; }
+
+	// 量化位置的还原矩阵，未量化时为单位矩阵；需要乘在模型矩阵右侧
+	inline const glm::mat4& GetDequantizeMatrix() const { return m_DequantizeMatrix; }
+
+private:
+	void SetDequantize(const float* scale, const float* offset);
+
+private:
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+	unsigned int m_VertexCount;
+	unsigned int m_VertexDataSize;
+	unsigned int m_IndexDataSize;
+	glm::mat4 m_DequantizeMatrix;
+};
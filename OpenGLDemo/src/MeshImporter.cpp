@@ -0,0 +1,626 @@
+#include "MeshImporter.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+	const int NoIndex = INT_MIN;
+	const size_t MinBytesPerThread = 1 << 20;
+
+	// 面顶点，索引为 0 基；负索引在解析时记为相对分块起点的偏移，合并分块后再转换为全局索引
+	struct ObjCorner
+	{
+		int Position;
+		int TexCoord;
+		int Normal;
+		unsigned char RelativeMask;
+	};
+
+	struct ObjChunk
+	{
+		const char* Begin;
+		const char* End;
+		std::vector<float> Positions;
+		std::vector<float> TexCoords;
+		std::vector<float> Normals;
+		std::vector<ObjCorner> Corners;
+		unsigned int PositionOffset = 0;
+		unsigned int TexCoordOffset = 0;
+		unsigned int NormalOffset = 0;
+		unsigned int InvalidCorners = 0;
+	};
+
+	inline const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t'))
+			p++;
+		return p;
+	}
+
+	inline const char* SkipLine(const char* p, const char* end)
+	{
+		while (p < end && *p != '\n')
+			p++;
+		return p < end ? p + 1 : end;
+	}
+
+	// 比 strtof 快得多的浮点解析：尾数累加到 64 位整数，再乘以 10 的幂
+	const char* ParseFloat(const char* p, const char* end, float& out)
+	{
+		static const double Pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		p = SkipSpaces(p, end);
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		unsigned long long mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+			if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); digits++; }
+			else exponent++;
+			p++;
+		}
+		if (p < end && *p == '.')
+		{
+			p++;
+			while (p < end && *p >= '0' && *p <= '9')
+			{
+				if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); digits++; exponent--; }
+				p++;
+			}
+		}
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+			bool negativeExponent = false;
+			if (p < end && (*p == '-' || *p == '+'))
+				negativeExponent = *p++ == '-';
+			int e = 0;
+			while (p < end && *p >= '0' && *p <= '9')
+			{
+				if (e < 10000) e = e * 10 + (*p - '0');
+				p++;
+			}
+			exponent += negativeExponent ? -e : e;
+		}
+
+		double value = (double)mantissa;
+		if (exponent < 0)
+			value = exponent >= -22 ? value / Pow10[-exponent] : value * std::pow(10.0, exponent);
+		else if (exponent > 0)
+			value = exponent <= 22 ? value * Pow10[exponent] : value * std::pow(10.0, exponent);
+		out = (float)(negative ? -value : value);
+		return p;
+	}
+
+	inline const char* ParseInt(const char* p, const char* end, int& out)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+		int value = 0;
+		while (p < end && *p >= '0' && *p <= '9')
+			value = value * 10 + (*p++ - '0');
+		out = negative ? -value : value;
+		return p;
+	}
+
+	// OBJ 索引从 1 开始，负数表示从当前已读数量往前数
+	inline int ToCornerIndex(int value, unsigned int localCount, unsigned char relativeBit, unsigned char& mask)
+	{
+		if (value > 0)
+			return value - 1;
+		if (value < 0)
+		{
+			mask |= relativeBit;
+			return (int)localCount + value;
+		}
+		return NoIndex;
+	}
+
+	void ParseChunk(ObjChunk& chunk)
+	{
+		const char* p = chunk.Begin;
+		const char* end = chunk.End;
+		std::vector<ObjCorner> polygon;
+
+		while (p < end)
+		{
+			p = SkipSpaces(p, end);
+			if (p + 1 >= end)
+				break;
+
+			if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+			{
+				float x, y, z;
+				p = ParseFloat(p + 2, end, x);
+				p = ParseFloat(p, end, y);
+				p = ParseFloat(p, end, z);
+				chunk.Positions.push_back(x);
+				chunk.Positions.push_back(y);
+				chunk.Positions.push_back(z);
+			}
+			else if (p[0] == 'v' && p[1] == 't')
+			{
+				float u, v;
+				p = ParseFloat(p + 2, end, u);
+				p = ParseFloat(p, end, v);
+				chunk.TexCoords.push_back(u);
+				chunk.TexCoords.push_back(v);
+			}
+			else if (p[0] == 'v' && p[1] == 'n')
+			{
+				float x, y, z;
+				p = ParseFloat(p + 2, end, x);
+				p = ParseFloat(p, end, y);
+				p = ParseFloat(p, end, z);
+				chunk.Normals.push_back(x);
+				chunk.Normals.push_back(y);
+				chunk.Normals.push_back(z);
+			}
+			else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+			{
+				p += 2;
+				polygon.clear();
+				const unsigned int positionCount = (unsigned int)chunk.Positions.size() / 3;
+				const unsigned int texCoordCount = (unsigned int)chunk.TexCoords.size() / 2;
+				const unsigned int normalCount = (unsigned int)chunk.Normals.size() / 3;
+				while (true)
+				{
+					p = SkipSpaces(p, end);
+					if (p >= end || *p == '\n' || *p == '\r' || *p == '#')
+						break;
+
+					ObjCorner corner = { NoIndex, NoIndex, NoIndex, 0 };
+					int value = 0;
+					p = ParseInt(p, end, value);
+					corner.Position = ToCornerIndex(value, positionCount, 1, corner.RelativeMask);
+					if (p < end && *p == '/')
+					{
+						p++;
+						if (p < end && *p != '/')
+						{
+							p = ParseInt(p, end, value);
+							corner.TexCoord = ToCornerIndex(value, texCoordCount, 2, corner.RelativeMask);
+						}
+						if (p < end && *p == '/')
+						{
+							p = ParseInt(p + 1, end, value);
+							corner.Normal = ToCornerIndex(value, normalCount, 4, corner.RelativeMask);
+						}
+					}
+					if (corner.Position == NoIndex)
+						break;
+					polygon.push_back(corner);
+				}
+
+				// 扇形三角化
+				for (size_t i = 2; i < polygon.size(); i++)
+				{
+					chunk.Corners.push_back(polygon[0]);
+					chunk.Corners.push_back(polygon[i - 1]);
+					chunk.Corners.push_back(polygon[i]);
+				}
+			}
+
+			p = SkipLine(p, end);
+		}
+	}
+
+	// 把分块内的相对索引转换为全局索引，并检查越界
+	void ResolveChunk(ObjChunk& chunk, unsigned int positionCount, unsigned int texCoordCount, unsigned int normalCount)
+	{
+		for (ObjCorner& corner : chunk.Corners)
+		{
+			if (corner.RelativeMask & 1) corner.Position += chunk.PositionOffset;
+			if (corner.RelativeMask & 2) corner.TexCoord += chunk.TexCoordOffset;
+			if (corner.RelativeMask & 4) corner.Normal += chunk.NormalOffset;
+
+			if (corner.Position < 0 || corner.Position >= (int)positionCount)
+			{
+				corner.Position = 0;
+				chunk.InvalidCorners++;
+			}
+			if (corner.TexCoord != NoIndex && (corner.TexCoord < 0 || corner.TexCoord >= (int)texCoordCount))
+				corner.TexCoord = NoIndex;
+			if (corner.Normal != NoIndex && (corner.Normal < 0 || corner.Normal >= (int)normalCount))
+				corner.Normal = NoIndex;
+		}
+	}
+
+	// 开放寻址哈希表，按 (position, texCoord, normal) 去重顶点
+	class CornerTable
+	{
+	public:
+		CornerTable(size_t expectedCount)
+			: m_Count(0)
+		{
+			size_t capacity = 1024;
+			while (capacity < expectedCount * 2)
+				capacity <<= 1;
+			m_Slots.assign(capacity, Slot{ -1, 0, 0, 0 });
+		}
+
+		// 返回已有顶点的索引，或插入 newIndex 并返回它
+		unsigned int FindOrInsert(const ObjCorner& corner, unsigned int newIndex)
+		{
+			if ((m_Count + 1) * 2 > m_Slots.size())
+				Grow();
+
+			size_t mask = m_Slots.size() - 1;
+			size_t i = Hash(corner.Position, corner.TexCoord, corner.Normal) & mask;
+			while (true)
+			{
+				Slot& slot = m_Slots[i];
+				if (slot.Position < 0)
+				{
+					slot = Slot{ corner.Position, corner.TexCoord, corner.Normal, newIndex };
+					m_Count++;
+					return newIndex;
+				}
+				if (slot.Position == corner.Position && slot.TexCoord == corner.TexCoord && slot.Normal == corner.Normal)
+					return slot.Index;
+				i = (i + 1) & mask;
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			int Position;
+			int TexCoord;
+			int Normal;
+			unsigned int Index;
+		};
+
+		static size_t Hash(int p, int t, int n)
+		{
+			unsigned long long h = (unsigned int)p;
+			h = h * 0x9E3779B97F4A7C15ULL ^ (unsigned int)t;
+			h = h * 0x9E3779B97F4A7C15ULL ^ (unsigned int)n;
+			h *= 0x9E3779B97F4A7C15ULL;
+			return (size_t)(h >> 17);
+		}
+
+		void Grow()
+		{
+			std::vector<Slot> old;
+			old.swap(m_Slots);
+			m_Slots.assign(old.size() * 2, Slot{ -1, 0, 0, 0 });
+			size_t mask = m_Slots.size() - 1;
+			for (const Slot& slot : old)
+			{
+				if (slot.Position < 0)
+					continue;
+				size_t i = Hash(slot.Position, slot.TexCoord, slot.Normal) & mask;
+				while (m_Slots[i].Position >= 0)
+					i = (i + 1) & mask;
+				m_Slots[i] = slot;
+			}
+		}
+
+		std::vector<Slot> m_Slots;
+		size_t m_Count;
+	};
+
+	double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+}
+
+bool MeshImporter::LoadObj(const std::string& filePath, MeshData& mesh, MeshImportStats* stats)
+{
+	MappedFile file(filePath);
+	if (!file.IsValid())
+	{
+		std::cout << "Failed to load mesh: " << filePath << std::endl;
+		return false;
+	}
+
+	auto parseStart = std::chrono::high_resolution_clock::now();
+
+	// 按行边界把文件切成若干块，每个线程解析一块
+	const char* data = file.GetData();
+	const char* end = data + file.GetSize();
+	unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threadCount = (unsigned int)std::min<size_t>(threadCount, std::max<size_t>(1, file.GetSize() / MinBytesPerThread));
+
+	std::vector<ObjChunk> chunks(threadCount);
+	const char* chunkBegin = data;
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		const char* chunkEnd = i + 1 == threadCount ? end : data + file.GetSize() / threadCount * (i + 1);
+		chunkEnd = std::max(chunkEnd, chunkBegin);
+		while (chunkEnd > data && chunkEnd < end && chunkEnd[-1] != '\n')
+			chunkEnd++;
+		chunks[i].Begin = chunkBegin;
+		chunks[i].End = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threadCount; i++)
+		workers.emplace_back(ParseChunk, std::ref(chunks[i]));
+	ParseChunk(chunks[0]);
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+
+	double parseMilliseconds = MillisecondsSince(parseStart);
+	auto buildStart = std::chrono::high_resolution_clock::now();
+
+	// 合并各分块的属性数组
+	unsigned int positionCount = 0, texCoordCount = 0, normalCount = 0;
+	size_t cornerCount = 0;
+	for (ObjChunk& chunk : chunks)
+	{
+		chunk.PositionOffset = positionCount;
+		chunk.TexCoordOffset = texCoordCount;
+		chunk.NormalOffset = normalCount;
+		positionCount += (unsigned int)chunk.Positions.size() / 3;
+		texCoordCount += (unsigned int)chunk.TexCoords.size() / 2;
+		normalCount += (unsigned int)chunk.Normals.size() / 3;
+		cornerCount += chunk.Corners.size();
+	}
+
+	if (positionCount == 0 || cornerCount == 0)
+	{
+		std::cout << "Failed to load mesh: " << filePath << " has no faces" << std::endl;
+		return false;
+	}
+
+	for (unsigned int i = 1; i < threadCount; i++)
+		workers.emplace_back(ResolveChunk, std::ref(chunks[i]), positionCount, texCoordCount, normalCount);
+	ResolveChunk(chunks[0], positionCount, texCoordCount, normalCount);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	std::vector<float> positions, texCoords, normals;
+	positions.reserve(positionCount * 3);
+	texCoords.reserve(texCoordCount * 2);
+	normals.reserve(normalCount * 3);
+	unsigned int invalidCorners = 0;
+	for (ObjChunk& chunk : chunks)
+	{
+		positions.insert(positions.end(), chunk.Positions.begin(), chunk.Positions.end());
+		texCoords.insert(texCoords.end(), chunk.TexCoords.begin(), chunk.TexCoords.end());
+		normals.insert(normals.end(), chunk.Normals.begin(), chunk.Normals.end());
+		invalidCorners += chunk.InvalidCorners;
+		std::vector<float>().swap(chunk.Positions);
+		std::vector<float>().swap(chunk.TexCoords);
+		std::vector<float>().swap(chunk.Normals);
+	}
+	if (invalidCorners > 0)
+		std::cout << "Warring:: " << filePath << " has " << invalidCorners << " out of range face indices" << std::endl;
+
+	// 顶点去重，生成索引
+	const unsigned int floatsPerVertex = 8;
+	mesh.Layout = VertexBufferLayout();
+	mesh.Layout.Push<float>(3);
+	mesh.Layout.Push<float>(2);
+	mesh.Layout.Push<float>(3);
+	mesh.Indices.clear();
+	mesh.IndexType = GL_UNSIGNED_INT;
+	mesh.Quantized = false;
+	std::vector<float> vertices;
+	vertices.reserve(positionCount * floatsPerVertex);
+	mesh.Indices.reserve(cornerCount);
+
+	bool needNormals = false;
+	CornerTable table(positionCount);
+	for (const ObjChunk& chunk : chunks)
+	{
+		for (const ObjCorner& corner : chunk.Corners)
+		{
+			unsigned int newIndex = (unsigned int)(vertices.size() / floatsPerVertex);
+			unsigned int index = table.FindOrInsert(corner, newIndex);
+			if (index == newIndex)
+			{
+				const float* p = &positions[corner.Position * 3];
+				vertices.insert(vertices.end(), p, p + 3);
+				if (corner.TexCoord != NoIndex)
+					vertices.insert(vertices.end(), &texCoords[corner.TexCoord * 2], &texCoords[corner.TexCoord * 2] + 2);
+				else
+					vertices.insert(vertices.end(), 2, 0.f);
+				if (corner.Normal != NoIndex)
+					vertices.insert(vertices.end(), &normals[corner.Normal * 3], &normals[corner.Normal * 3] + 3);
+				else
+				{
+					vertices.insert(vertices.end(), 3, 0.f);
+					needNormals = true;
+				}
+			}
+			mesh.Indices.push_back(index);
+		}
+	}
+	mesh.VertexCount = (unsigned int)(vertices.size() / floatsPerVertex);
+
+	// 没有法线的顶点用相邻面的面积加权法线代替
+	if (needNormals)
+	{
+		for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+		{
+			float* a = &vertices[mesh.Indices[i] * floatsPerVertex];
+			float* b = &vertices[mesh.Indices[i + 1] * floatsPerVertex];
+			float* c = &vertices[mesh.Indices[i + 2] * floatsPerVertex];
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			for (float* v : { a, b, c })
+				for (int k = 0; k < 3; k++)
+					v[5 + k] += n[k];
+		}
+		for (unsigned int i = 0; i < mesh.VertexCount; i++)
+		{
+			float* n = &vertices[i * floatsPerVertex + 5];
+			float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length > 0.f)
+				for (int k = 0; k < 3; k++)
+					n[k] /= length;
+		}
+	}
+
+	// 包围盒
+	for (int k = 0; k < 3; k++)
+	{
+		mesh.BoundsMin[k] = vertices[k];
+		mesh.BoundsMax[k] = vertices[k];
+		mesh.PositionScale[k] = 1.f;
+		mesh.PositionOffset[k] = 0.f;
+	}
+	for (size_t i = 0; i < vertices.size(); i += floatsPerVertex)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			mesh.BoundsMin[k] = std::min(mesh.BoundsMin[k], vertices[i + k]);
+			mesh.BoundsMax[k] = std::max(mesh.BoundsMax[k], vertices[i + k]);
+		}
+	}
+
+	mesh.VertexData.assign((const unsigned char*)vertices.data(), (const unsigned char*)(vertices.data() + vertices.size()));
+
+	if (stats)
+	{
+		stats->FileSize = file.GetSize();
+		stats->ThreadCount = threadCount;
+		stats->CornerCount = (unsigned int)cornerCount;
+		stats->ParseMilliseconds = parseMilliseconds;
+		stats->BuildMilliseconds = MillisecondsSince(buildStart);
+	}
+	return true;
+}
+
+std::vector<unsigned short> MeshImporter::NarrowIndices(const std::vector<unsigned int>& indices)
+{
+	return std::vector<unsigned short>(indices.begin(), indices.end());
+}
+
+bool MeshImporter::WriteCooked(const std::string& filePath, const MeshData& mesh)
+{
+	const auto& elements = mesh.Layout.GetElements();
+	const unsigned int indexSize = mesh.IndexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+
+	CookedMeshHeader header;
+	memcpy(header.Magic, "OGDM", 4);
+	header.Version = CookedVersion;
+	header.VertexCount = mesh.VertexCount;
+	header.IndexCount = (unsigned int)mesh.Indices.size();
+	header.IndexType = mesh.IndexType;
+	header.Stride = mesh.Layout.GetStride();
+	header.ElementCount = (unsigned int)elements.size();
+	header.VertexDataOffset = (unsigned int)(sizeof(CookedMeshHeader) + elements.size() * sizeof(CookedMeshElement));
+	header.VertexDataSize = (unsigned int)mesh.VertexData.size();
+	header.IndexDataOffset = header.VertexDataOffset + header.VertexDataSize;
+	header.IndexDataSize = (unsigned int)mesh.Indices.size() * indexSize;
+	memcpy(header.PositionScale, mesh.PositionScale, sizeof(header.PositionScale));
+	memcpy(header.PositionOffset, mesh.PositionOffset, sizeof(header.PositionOffset));
+	memcpy(header.BoundsMin, mesh.BoundsMin, sizeof(header.BoundsMin));
+	memcpy(header.BoundsMax, mesh.BoundsMax, sizeof(header.BoundsMax));
+
+	std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		std::cout << "Failed to write cooked mesh: " << filePath << std::endl;
+		return false;
+	}
+
+	stream.write((const char*)&header, sizeof(header));
+	for (const auto& element : elements)
+	{
+		CookedMeshElement cooked = { element.type, element.count, element.normalized };
+		stream.write((const char*)&cooked, sizeof(cooked));
+	}
+	stream.write((const char*)mesh.VertexData.data(), header.VertexDataSize);
+	if (mesh.IndexType == GL_UNSIGNED_SHORT)
+		stream.write((const char*)NarrowIndices(mesh.Indices).data(), header.IndexDataSize);
+	else
+		stream.write((const char*)mesh.Indices.data(), header.IndexDataSize);
+	return (bool)stream;
+}
+
+bool MeshImporter::IsCookedHeaderValid(const CookedMeshHeader& header, size_t fileSize)
+{
+	if (memcmp(header.Magic, "OGDM", 4) != 0 || header.Version != CookedVersion)
+		return false;
+	if (header.IndexType != GL_UNSIGNED_INT && header.IndexType != GL_UNSIGNED_SHORT)
+		return false;
+
+	// 全部用 64 位计算，损坏的文件不能通过溢出绕过检查
+	const unsigned long long size = fileSize;
+	const unsigned long long indexSize = header.IndexType == GL_UNSIGNED_SHORT ? 2 : 4;
+	if (header.VertexDataOffset != sizeof(CookedMeshHeader) + (unsigned long long)header.ElementCount * sizeof(CookedMeshElement))
+		return false;
+	if (header.VertexDataSize != (unsigned long long)header.VertexCount * header.Stride)
+		return false;
+	if (header.IndexDataOffset != (unsigned long long)header.VertexDataOffset + header.VertexDataSize)
+		return false;
+	if (header.IndexDataSize != (unsigned long long)header.IndexCount * indexSize)
+		return false;
+	if ((unsigned long long)header.VertexDataOffset + header.VertexDataSize > size)
+		return false;
+	return (unsigned long long)header.IndexDataOffset + header.IndexDataSize <= size;
+}
+
+bool MeshImporter::IsCookedElementValid(const CookedMeshElement& element)
+{
+	if (element.Normalized > 1)
+		return false;
+	switch (element.Type)
+	{
+	case GL_FLOAT:
+	case GL_UNSIGNED_INT:
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+	case GL_HALF_FLOAT:
+		return element.Count >= 1 && element.Count <= 4;
+	case GL_INT_2_10_10_10_REV:
+		return element.Count == 4;
+	default:
+		return false;
+	}
+}
+
+bool MeshImporter::IsCookedIndexDataValid(const CookedMeshHeader& header, const char* fileData)
+{
+	// 索引数据在文件中不保证 4 字节对齐，用 memcpy 读取
+	const char* indices = fileData + header.IndexDataOffset;
+	unsigned int maxIndex = 0;
+	if (header.IndexType == GL_UNSIGNED_SHORT)
+	{
+		for (unsigned int i = 0; i < header.IndexCount; i++)
+		{
+			unsigned short index;
+			memcpy(&index, indices + i * sizeof(unsigned short), sizeof(index));
+			maxIndex = std::max(maxIndex, (unsigned int)index);
+		}
+	}
+	else
+	{
+		for (unsigned int i = 0; i < header.IndexCount; i++)
+		{
+			unsigned int index;
+			memcpy(&index, indices + (size_t)i * sizeof(unsigned int), sizeof(index));
+			maxIndex = std::max(maxIndex, index);
+		}
+	}
+	return header.IndexCount == 0 || maxIndex < header.VertexCount;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "VertexBufferLayout.h"
+
+// CPU 端的网格数据
+// 导入后顶点格式为 position(3 float) + texCoord(2 float) + normal(3 float)，经过 MeshOptimizer::Quantize 后变为压缩格式
+struct MeshData
+{
+	VertexBufferLayout Layout;
+	std::vector<unsigned char> VertexData;
+	std::vector<unsigned int> Indices;      // CPU 端始终为 32 位，上传/烘焙时按 IndexType 转换
+	unsigned int VertexCount = 0;
+	unsigned int IndexType = GL_UNSIGNED_INT;
+	bool Quantized = false;
+
+	float BoundsMin[3] = { 0.f, 0.f, 0.f };
+	float BoundsMax[3] = { 0.f, 0.f, 0.f };
+	// 量化后的位置需要还原：position = stored * PositionScale + PositionOffset
+	float PositionScale[3] = { 1.f, 1.f, 1.f };
+	float PositionOffset[3] = { 0.f, 0.f, 0.f };
+};
+
+struct MeshImportStats
+{
+	size_t FileSize = 0;
+	unsigned int ThreadCount = 0;
+	unsigned int CornerCount = 0;       // 三角化后的面顶点数（去重前）
+	double ParseMilliseconds = 0.0;     // 多线程解析文本
+	double BuildMilliseconds = 0.0;     // 索引解析、顶点去重、生成顶点缓存
+
+	inline double GetParseThroughput() const { return ParseMilliseconds > 0.0 ? (FileSize / (1024.0 * 1024.0)) / (ParseMilliseconds / 1000.0) : 0.0; }
+};
+
+// 烘焙后的二进制网格格式 (.mesh)
+// [CookedMeshHeader][CookedMeshElement * ElementCount][顶点数据][索引数据]
+// 顶点布局直接对应 VertexBufferLayout，加载时只需要映射文件并上传缓冲
+struct CookedMeshHeader
+{
+	char Magic[4];
+	unsigned int Version;
+	unsigned int VertexCount;
+	unsigned int IndexCount;
+	unsigned int IndexType;
+	unsigned int Stride;
+	unsigned int ElementCount;
+	unsigned int VertexDataOffset;
+	unsigned int VertexDataSize;
+	unsigned int IndexDataOffset;
+	unsigned int IndexDataSize;
+	float PositionScale[3];
+	float PositionOffset[3];
+	float BoundsMin[3];
+	float BoundsMax[3];
+};
+
+struct CookedMeshElement
+{
+	unsigned int Type;
+	unsigned int Count;
+	unsigned int Normalized;
+};
+
+class MeshImporter
+{
+public:
+	static const unsigned int CookedVersion = 2;
+
+	// 解析 Wavefront OBJ，支持 v/vt/vn/f（多边形按扇形三角化，支持负索引）
+	static bool LoadObj(const std::string& filePath, MeshData& mesh, MeshImportStats* stats = nullptr);
+
+	// 把 32 位索引转换为 16 位，调用方需保证顶点数不超过 65536
+	static std::vector<unsigned short> NarrowIndices(const std::vector<unsigned int>& indices);
+
+	static bool WriteCooked(const std::string& filePath, const MeshData& mesh);
+	// 检查头部的偏移和大小都在文件范围内，且与写入时的布局一致
+	static bool IsCookedHeaderValid(const CookedMeshHeader& header, size_t fileSize);
+	// 只接受 VertexBufferElement 支持的类型
+	static bool IsCookedElementValid(const CookedMeshElement& element);
+	// 扫描一遍索引数据（头部已经通过检查），所有索引都必须小于 VertexCount
+	static bool IsCookedIndexDataValid(const CookedMeshHeader& header, const char* fileData);
+};
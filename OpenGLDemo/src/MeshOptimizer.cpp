@@ -0,0 +1,435 @@
+#include "MeshOptimizer.h"
+
+#include "MeshImporter.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/packing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	// Forsyth 算法的参数，见 "Linear-Speed Vertex Cache Optimisation"
+	const int ForsythCacheSize = 32;
+	const int ForsythValenceTableSize = 32;
+	const float ForsythCacheDecayPower = 1.5f;
+	const float ForsythLastTriScore = 0.75f;
+	const float ForsythValenceBoostScale = 2.0f;
+	const float ForsythValenceBoostPower = 0.5f;
+
+	// 簇太小会破坏顶点缓存的连续性
+	const unsigned int MinClusterTriangles = 16;
+
+	struct ForsythTables
+	{
+		float CacheScore[ForsythCacheSize];
+		float ValenceScore[ForsythValenceTableSize];
+
+		ForsythTables()
+		{
+			for (int i = 0; i < ForsythCacheSize; i++)
+			{
+				if (i < 3)
+					CacheScore[i] = ForsythLastTriScore;
+				else
+					CacheScore[i] = std::pow(1.f - (float)(i - 3) / (ForsythCacheSize - 3), ForsythCacheDecayPower);
+			}
+			for (int i = 0; i < ForsythValenceTableSize; i++)
+				ValenceScore[i] = i > 0 ? ForsythValenceBoostScale * std::pow((float)i, -ForsythValenceBoostPower) : 0.f;
+		}
+
+		float GetVertexScore(int cachePosition, unsigned int remaining) const
+		{
+			if (remaining == 0)
+				return -1.f;
+			float score = cachePosition >= 0 ? CacheScore[cachePosition] : 0.f;
+			score += remaining < (unsigned int)ForsythValenceTableSize ? ValenceScore[remaining] : ForsythValenceBoostScale * std::pow((float)remaining, -ForsythValenceBoostPower);
+			return score;
+		}
+	};
+
+	inline glm::vec3 ReadPosition(const MeshData& mesh, unsigned int vertex)
+	{
+		glm::vec3 position;
+		memcpy(&position, &mesh.VertexData[(size_t)vertex * mesh.Layout.GetStride()], sizeof(position));
+		return position;
+	}
+
+	// 导入器输出的未压缩格式：position(3 float) + texCoord(2 float) + normal(3 float)
+	bool IsFloatLayout(const MeshData& mesh)
+	{
+		const auto& elements = mesh.Layout.GetElements();
+		return !mesh.Quantized && elements.size() == 3
+			&& elements[0].type == GL_FLOAT && elements[0].count == 3
+			&& elements[1].type == GL_FLOAT && elements[1].count == 2
+			&& elements[2].type == GL_FLOAT && elements[2].count == 3;
+	}
+
+	unsigned int GetIndexSize(unsigned int indexType)
+	{
+		return indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	}
+
+}
+
+MeshOptimizeReport MeshOptimizer::Optimize(MeshData& mesh, const MeshOptimizeSettings& settings)
+{
+	MeshOptimizeReport report;
+	report.Before = AnalyzeVertexCache(mesh.Indices, mesh.VertexCount);
+	report.VertexBytesBefore = (unsigned int)mesh.VertexData.size();
+	report.IndexBytesBefore = (unsigned int)mesh.Indices.size() * GetIndexSize(mesh.IndexType);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (settings.VertexCache)
+		OptimizeVertexCache(mesh.Indices, mesh.VertexCount);
+	if (settings.Overdraw && IsFloatLayout(mesh))
+		report.ClusterCount = OptimizeOverdraw(mesh.Indices, mesh, settings.OverdrawThreshold);
+	if (settings.VertexFetch)
+		OptimizeVertexFetch(mesh);
+	if (settings.ShortIndices && mesh.VertexCount <= 65536)
+		mesh.IndexType = GL_UNSIGNED_SHORT;
+	if (settings.Quantize && IsFloatLayout(mesh))
+		Quantize(mesh);
+
+	report.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	report.After = AnalyzeVertexCache(mesh.Indices, mesh.VertexCount);
+	report.VertexBytesAfter = (unsigned int)mesh.VertexData.size();
+	report.IndexBytesAfter = (unsigned int)mesh.Indices.size() * GetIndexSize(mesh.IndexType);
+	return report;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount)
+{
+	static const ForsythTables tables;
+
+	const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// 每个顶点相邻的三角形列表
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (unsigned int index : indices)
+		remaining[index]++;
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency(indices.size());
+	{
+		std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+		for (unsigned int t = 0; t < triangleCount; t++)
+			for (int k = 0; k < 3; k++)
+				adjacency[fill[indices[t * 3 + k]]++] = t;
+	}
+
+	std::vector<float> vertexScore(vertexCount);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		vertexScore[v] = tables.GetVertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	unsigned int bestTriangle = 0;
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[bestTriangle])
+			bestTriangle = t;
+	}
+
+	std::vector<unsigned int> output;
+	output.reserve(indices.size());
+	unsigned int cache[ForsythCacheSize + 3];
+	unsigned int cacheCount = 0;
+	unsigned int scanCursor = 0;
+
+	for (unsigned int emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		// 缓存里没有候选三角形时，按顺序取下一个未输出的三角形
+		if (bestTriangle == ~0u)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+			bestTriangle = scanCursor;
+		}
+
+		const unsigned int* tri = &indices[bestTriangle * 3];
+		emitted[bestTriangle] = true;
+		output.insert(output.end(), tri, tri + 3);
+
+		// 从顶点的相邻列表中移除该三角形
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int v = tri[k];
+			unsigned int* begin = &adjacency[offsets[v]];
+			unsigned int* end = begin + remaining[v];
+			unsigned int* it = std::find(begin, end, bestTriangle);
+			std::swap(*it, *(end - 1));
+			remaining[v]--;
+		}
+
+		// 三个顶点移到 LRU 缓存最前面
+		unsigned int newCache[ForsythCacheSize + 3];
+		unsigned int newCount = 0;
+		for (int k = 0; k < 3; k++)
+			newCache[newCount++] = tri[k];
+		for (unsigned int i = 0; i < cacheCount; i++)
+		{
+			unsigned int v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+
+		// 更新缓存内顶点的分数，并在它们的相邻三角形中找下一个最佳三角形
+		bestTriangle = ~0u;
+		float bestScore = -1.f;
+		for (unsigned int i = 0; i < newCount; i++)
+		{
+			unsigned int v = newCache[i];
+			int position = i < (unsigned int)ForsythCacheSize ? (int)i : -1;
+			float score = tables.GetVertexScore(position, remaining[v]);
+			float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			for (unsigned int a = 0; a < remaining[v]; a++)
+			{
+				unsigned int t = adjacency[offsets[v] + a];
+				triangleScore[t] += delta;
+				if (position >= 0 && triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		cacheCount = std::min(newCount, (unsigned int)ForsythCacheSize);
+		memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+	}
+
+	indices.swap(output);
+}
+
+unsigned int MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const MeshData& mesh, float threshold)
+{
+	const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	if (triangleCount == 0)
+		return 0;
+
+	// 硬边界：顶点缓存被完全刷新的位置（三个顶点都未命中）
+	std::vector<unsigned int> hardStarts;
+	{
+		std::vector<unsigned int> timestamps(mesh.VertexCount, 0);
+		unsigned int time = CacheSize + 1;
+		for (unsigned int t = 0; t < triangleCount; t++)
+		{
+			unsigned int misses = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[t * 3 + k];
+				if (time - timestamps[v] > CacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			if (t == 0 || misses == 3)
+				hardStarts.push_back(t);
+		}
+		hardStarts.push_back(triangleCount);
+	}
+
+	// 软边界：簇从空缓存开始，累计 ACMR 回落到 threshold * 原 ACMR 以内时就切分，保证重排后的缓存效率损失有上限
+	std::vector<unsigned int> clusterStarts;
+	{
+		std::vector<unsigned int> timestamps(mesh.VertexCount, 0);
+		unsigned int time = CacheSize + 1;
+		auto countMisses = [&](unsigned int t)
+		{
+			unsigned int misses = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[t * 3 + k];
+				if (time - timestamps[v] > CacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			return misses;
+		};
+
+		for (size_t h = 0; h + 1 < hardStarts.size(); h++)
+		{
+			const unsigned int begin = hardStarts[h], end = hardStarts[h + 1];
+
+			time += CacheSize + 1;
+			unsigned int hardMisses = 0;
+			for (unsigned int t = begin; t < end; t++)
+				hardMisses += countMisses(t);
+			const float clusterThreshold = threshold * hardMisses / (end - begin);
+
+			time += CacheSize + 1;
+			unsigned int start = begin, misses = 0;
+			clusterStarts.push_back(begin);
+			for (unsigned int t = begin; t < end; t++)
+			{
+				misses += countMisses(t);
+				unsigned int size = t - start + 1;
+				if (t + 1 < end && size >= MinClusterTriangles && misses <= clusterThreshold * size)
+				{
+					clusterStarts.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					time += CacheSize + 1;
+				}
+			}
+		}
+	}
+	const unsigned int clusterCount = (unsigned int)clusterStarts.size();
+	clusterStarts.push_back(triangleCount);
+	if (clusterCount < 2)
+		return clusterCount;
+
+	// 每个簇的面积加权中心和平均法线
+	std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.f));
+	std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.f));
+	glm::vec3 meshCentroid(0.f);
+	float meshArea = 0.f;
+	for (unsigned int c = 0; c < clusterCount; c++)
+	{
+		float clusterArea = 0.f;
+		for (unsigned int t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+		{
+			glm::vec3 a = ReadPosition(mesh, indices[t * 3]);
+			glm::vec3 b = ReadPosition(mesh, indices[t * 3 + 1]);
+			glm::vec3 d = ReadPosition(mesh, indices[t * 3 + 2]);
+			glm::vec3 normal = glm::cross(b - a, d - a);
+			float area = glm::length(normal);
+			clusterCentroid[c] += (a + b + d) * (area / 3.f);
+			clusterNormal[c] += normal;
+			clusterArea += area;
+		}
+		meshCentroid += clusterCentroid[c];
+		meshArea += clusterArea;
+		if (clusterArea > 0.f)
+			clusterCentroid[c] /= clusterArea;
+	}
+	if (meshArea > 0.f)
+		meshCentroid /= meshArea;
+
+	// 朝外程度越高的簇越先绘制
+	std::vector<float> sortKey(clusterCount);
+	std::vector<unsigned int> order(clusterCount);
+	for (unsigned int c = 0; c < clusterCount; c++)
+	{
+		float length = glm::length(clusterNormal[c]);
+		sortKey[c] = length > 0.f ? glm::dot(clusterCentroid[c] - meshCentroid, clusterNormal[c] / length) : 0.f;
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<unsigned int> sorted;
+	sorted.reserve(indices.size());
+	for (unsigned int c : order)
+		sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+
+	indices.swap(sorted);
+	return clusterCount;
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh)
+{
+	const unsigned int stride = mesh.Layout.GetStride();
+	std::vector<unsigned int> remap(mesh.VertexCount, ~0u);
+	std::vector<unsigned char> vertexData(mesh.VertexData.size());
+
+	// 未被引用的顶点会被丢弃
+	unsigned int next = 0;
+	for (unsigned int& index : mesh.Indices)
+	{
+		if (remap[index] == ~0u)
+		{
+			remap[index] = next;
+			memcpy(&vertexData[(size_t)next * stride], &mesh.VertexData[(size_t)index * stride], stride);
+			next++;
+		}
+		index = remap[index];
+	}
+
+	vertexData.resize((size_t)next * stride);
+	mesh.VertexData.swap(vertexData);
+	mesh.VertexCount = next;
+}
+
+void MeshOptimizer::Quantize(MeshData& mesh)
+{
+	const unsigned int sourceStride = mesh.Layout.GetStride();
+
+	glm::vec3 minBounds(mesh.BoundsMin[0], mesh.BoundsMin[1], mesh.BoundsMin[2]);
+	glm::vec3 maxBounds(mesh.BoundsMax[0], mesh.BoundsMax[1], mesh.BoundsMax[2]);
+	glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+	glm::vec3 halfExtent = glm::max((maxBounds - minBounds) * 0.5f, glm::vec3(1e-6f));
+
+	VertexBufferLayout layout;
+	layout.Push(VertexBufferElement(GL_SHORT, 4, GL_TRUE));
+	layout.Push(VertexBufferElement(GL_HALF_FLOAT, 2, GL_FALSE));
+	layout.Push(VertexBufferElement(GL_INT_2_10_10_10_REV, 4, GL_TRUE));
+	const unsigned int stride = layout.GetStride();
+
+	std::vector<unsigned char> vertexData((size_t)mesh.VertexCount * stride);
+	for (unsigned int v = 0; v < mesh.VertexCount; v++)
+	{
+		float source[8];
+		memcpy(source, &mesh.VertexData[(size_t)v * sourceStride], sizeof(source));
+		unsigned char* dst = &vertexData[(size_t)v * stride];
+
+		glm::vec3 position = glm::clamp((glm::vec3(source[0], source[1], source[2]) - center) / halfExtent, -1.f, 1.f);
+		short packedPosition[4] = {
+			(short)glm::packSnorm1x16(position.x),
+			(short)glm::packSnorm1x16(position.y),
+			(short)glm::packSnorm1x16(position.z),
+			0,
+		};
+		unsigned int packedTexCoord = glm::packHalf2x16(glm::vec2(source[3], source[4]));
+		unsigned int packedNormal = glm::packSnorm3x10_1x2(glm::vec4(source[5], source[6], source[7], 0.f));
+
+		memcpy(dst, packedPosition, sizeof(packedPosition));
+		memcpy(dst + 8, &packedTexCoord, sizeof(packedTexCoord));
+		memcpy(dst + 12, &packedNormal, sizeof(packedNormal));
+	}
+
+	mesh.VertexData.swap(vertexData);
+	mesh.Layout = layout;
+	mesh.Quantized = true;
+	for (int k = 0; k < 3; k++)
+	{
+		mesh.PositionScale[k] = halfExtent[k];
+		mesh.PositionOffset[k] = center[k];
+	}
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize)
+{
+	// FIFO 缓存模拟：顶点的时间戳在最近 cacheSize 次未命中之内即视为命中
+	VertexCacheStats stats;
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	for (unsigned int index : indices)
+	{
+		if (time - timestamps[index] > cacheSize)
+		{
+			timestamps[index] = time++;
+			stats.Misses++;
+		}
+	}
+
+	unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	stats.ACMR = triangleCount > 0 ? (float)stats.Misses / triangleCount : 0.f;
+	stats.ATVR = vertexCount > 0 ? (float)stats.Misses / vertexCount : 0.f;
+	return stats;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+struct MeshData;
+
+// 顶点缓存模拟结果
+struct VertexCacheStats
+{
+	unsigned int Misses = 0;
+	float ACMR = 0.f;   // 每个三角形的平均缓存未命中数，理想值 0.5
+	float ATVR = 0.f;   // 变换的顶点数 / 顶点总数，理想值 1.0
+};
+
+struct MeshOptimizeSettings
+{
+	bool VertexCache = true;
+	bool Overdraw = true;
+	bool VertexFetch = true;
+	bool ShortIndices = true;
+	bool Quantize = true;
+	// 允许为了减少 overdraw 而损失的 ACMR 比例
+	float OverdrawThreshold = 1.05f;
+};
+
+struct MeshOptimizeReport
+{
+	VertexCacheStats Before;
+	VertexCacheStats After;
+	unsigned int ClusterCount = 0;
+	unsigned int VertexBytesBefore = 0, VertexBytesAfter = 0;
+	unsigned int IndexBytesBefore = 0, IndexBytesAfter = 0;
+	double Milliseconds = 0.0;
+
+	inline int GetBytesSaved() const { return (int)(VertexBytesBefore + IndexBytesBefore) - (int)(VertexBytesAfter + IndexBytesAfter); }
+};
+
+// 导入后的网格优化：顶点缓存排序 -> overdraw 簇排序 -> 顶点读取排序 -> 16 位索引 -> 顶点量化
+class MeshOptimizer
+{
+public:
+	static const unsigned int CacheSize = 16;
+
+	static MeshOptimizeReport Optimize(MeshData& mesh, const MeshOptimizeSettings& settings = MeshOptimizeSettings());
+
+	// Forsyth 线性速度顶点缓存优化
+	static void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount);
+	// 按缓存边界切分为簇，再按簇朝外的程度排序，外侧的簇先画以利用 early-Z；返回簇数量
+	static unsigned int OptimizeOverdraw(std::vector<unsigned int>& indices, const MeshData& mesh, float threshold);
+	// 按首次使用顺序重排顶点，提高顶点读取的局部性
+	static void OptimizeVertexFetch(MeshData& mesh);
+	// 位置 -> 4 x GL_SHORT（归一化，配合 PositionScale/Offset 还原），texCoord -> 2 x GL_HALF_FLOAT，normal -> GL_INT_2_10_10_10_REV
+	static void Quantize(MeshData& mesh);
+
+	static VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize = CacheSize);
+};
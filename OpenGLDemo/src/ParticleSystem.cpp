@@ -0,0 +1,243 @@
+#include "ParticleSystem.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "Shader.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// x64 和开启 /arch:SSE 的 x86 都有 SSE，其他平台走标量路径
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define PARTICLE_SIMD 1
+#include <xmmintrin.h>
+#else
+#define PARTICLE_SIMD 0
+#endif
+
+namespace {
+
+	// 每个线程块至少处理的粒子数，太小的话调度开销会超过计算本身
+	const unsigned int MinParticlesPerTask = 16384;
+
+	double ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+}
+
+ParticlePool::ParticlePool(unsigned int capacity)
+	: PositionX(capacity), PositionY(capacity)
+	, VelocityX(capacity), VelocityY(capacity)
+	, Life(capacity), MaxLife(capacity)
+	, m_Count(0)
+	, m_Capacity(capacity)
+{
+}
+
+void ParticlePool::Emit(unsigned int count, const ParticleEmitterSettings& settings, std::mt19937& rng)
+{
+	count = std::min(count, m_Capacity - m_Count);
+
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	for (unsigned int i = m_Count; i < m_Count + count; i++)
+	{
+		float angle = settings.Direction + (unit(rng) - 0.5f) * settings.Spread;
+		float speed = settings.Speed * (0.5f + 0.5f * unit(rng));
+		PositionX[i] = settings.Position.x;
+		PositionY[i] = settings.Position.y;
+		VelocityX[i] = cosf(angle) * speed;
+		VelocityY[i] = sinf(angle) * speed;
+		Life[i] = MaxLife[i] = settings.Lifetime * (0.5f + 0.5f * unit(rng));
+	}
+	m_Count += count;
+}
+
+unsigned int ParticlePool::Compact()
+{
+	unsigned int removed = 0;
+	unsigned int i = 0;
+	while (i < m_Count)
+	{
+		if (Life[i] > 0.f)
+		{
+			i++;
+			continue;
+		}
+
+		// 不前移 i，换过来的粒子也需要检查
+		unsigned int last = --m_Count;
+		PositionX[i] = PositionX[last];
+		PositionY[i] = PositionY[last];
+		VelocityX[i] = VelocityX[last];
+		VelocityY[i] = VelocityY[last];
+		Life[i] = Life[last];
+		MaxLife[i] = MaxLife[last];
+		removed++;
+	}
+	return removed;
+}
+
+void ParticlePool::Simulate(unsigned int begin, unsigned int end, float deltaTime, const ParticleEmitterSettings& settings, bool useSIMD)
+{
+	float* px = PositionX.data();
+	float* py = PositionY.data();
+	float* vx = VelocityX.data();
+	float* vy = VelocityY.data();
+	float* life = Life.data();
+
+	float damping = std::max(0.f, 1.f - settings.Drag * deltaTime);
+	float gravity = settings.Gravity * deltaTime;
+
+	unsigned int i = begin;
+#if PARTICLE_SIMD
+	if (useSIMD)
+	{
+		__m128 dt = _mm_set1_ps(deltaTime);
+		__m128 g = _mm_set1_ps(gravity);
+		__m128 d = _mm_set1_ps(damping);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 velocityX = _mm_mul_ps(_mm_loadu_ps(vx + i), d);
+			__m128 velocityY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), g), d);
+			_mm_storeu_ps(vx + i, velocityX);
+			_mm_storeu_ps(vy + i, velocityY);
+			_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velocityX, dt)));
+			_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velocityY, dt)));
+			_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+		}
+	}
+#endif
+
+	// 标量路径，同时处理 SIMD 剩下的不足 4 个的尾部
+	for (; i < end; i++)
+	{
+		vx[i] *= damping;
+		vy[i] = (vy[i] + gravity) * damping;
+		px[i] += vx[i] * deltaTime;
+		py[i] += vy[i] * deltaTime;
+		life[i] -= deltaTime;
+	}
+}
+
+ParticleSystem::ParticleSystem(unsigned int capacity)
+	: m_Pool(capacity)
+	, m_Random(12777)
+	, m_EmitAccumulator(0.f)
+	, m_UseSIMD(true)
+	, m_UseThreads(true)
+{
+	m_ThreadPool = std::make_unique<ThreadPool>();
+
+	// 三角形带的四边形，每个粒子一个实例
+	float corners[] = {
+		-0.5f, -0.5f,
+		 0.5f, -0.5f,
+		-0.5f,  0.5f,
+		 0.5f,  0.5f,
+	};
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_QuadVBO = std::make_unique<VertexBuffer>(corners, sizeof(corners));
+	VertexBufferLayout layout;
+	layout.Push<float>(2);
+	m_VAO->AddBuffer(*m_QuadVBO, layout);
+
+	// 实例数据直接上传 SoA 数组：[X... | Y... | Life... | MaxLife...]，不需要转置成交错格式
+	m_InstanceVBO = std::make_unique<VertexBuffer>(capacity * 4 * (unsigned int)sizeof(float));
+	m_VAO->Bind();
+	m_InstanceVBO->Bind();
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		GLCALL(glEnableVertexAttribArray(1 + i));
+		GLCALL(glVertexAttribPointer(1 + i, 1, GL_FLOAT, GL_FALSE, sizeof(float), (const void*)(uintptr_t)(i * capacity * sizeof(float))));
+		GLCALL(glVertexAttribDivisor(1 + i, 1));
+	}
+	m_VAO->UnBind();
+
+	m_Shader = std::make_unique<Shader>("res/shaders/Particle.shader");
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+unsigned int ParticleSystem::GetThreadCount() const
+{
+	return m_UseThreads ? m_ThreadPool->GetThreadCount() : 1;
+}
+
+bool ParticleSystem::IsSIMDSupported()
+{
+	return PARTICLE_SIMD != 0;
+}
+
+void ParticleSystem::Update(float deltaTime, const ParticleEmitterSettings& settings)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	unsigned int count = m_Pool.GetCount();
+	if (m_UseThreads)
+	{
+		// 块大小按 4 对齐，保证只有最后一块有标量尾部
+		unsigned int granularity = std::max(MinParticlesPerTask, (count / (m_ThreadPool->GetThreadCount() * 4) + 3) & ~3u);
+		m_ThreadPool->ParallelFor(count, granularity, [&](unsigned int begin, unsigned int end) {
+			m_Pool.Simulate(begin, end, deltaTime, settings, m_UseSIMD);
+		});
+	}
+	else
+	{
+		m_Pool.Simulate(0, count, deltaTime, settings, m_UseSIMD);
+	}
+	m_Stats.SimulateMilliseconds = ElapsedMilliseconds(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	m_Stats.Removed = m_Pool.Compact();
+	m_Stats.CompactMilliseconds = ElapsedMilliseconds(start);
+
+	// 发射速率让粒子数稳定在容量附近（平均寿命为 0.75 * Lifetime）
+	start = std::chrono::high_resolution_clock::now();
+	m_EmitAccumulator += deltaTime * m_Pool.GetCapacity() / (0.75f * std::max(settings.Lifetime, 0.01f));
+	unsigned int emitCount = (unsigned int)m_EmitAccumulator;
+	m_EmitAccumulator -= (float)emitCount;
+	unsigned int before = m_Pool.GetCount();
+	m_Pool.Emit(emitCount, settings, m_Random);
+	m_Stats.Emitted = m_Pool.GetCount() - before;
+	m_Stats.EmitMilliseconds = ElapsedMilliseconds(start);
+
+	m_Stats.Alive = m_Pool.GetCount();
+}
+
+void ParticleSystem::Render(const glm::mat4& viewProjection, const ParticleEmitterSettings& settings)
+{
+	unsigned int count = m_Pool.GetCount();
+	if (count == 0)
+		return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	unsigned int capacityBytes = m_Pool.GetCapacity() * (unsigned int)sizeof(float);
+	unsigned int countBytes = count * (unsigned int)sizeof(float);
+	m_InstanceVBO->SetData(m_Pool.PositionX.data(), countBytes);
+	m_InstanceVBO->SetSubData(m_Pool.PositionY.data(), countBytes, capacityBytes);
+	m_InstanceVBO->SetSubData(m_Pool.Life.data(), countBytes, capacityBytes * 2);
+	m_InstanceVBO->SetSubData(m_Pool.MaxLife.data(), countBytes, capacityBytes * 3);
+	m_Stats.UploadMilliseconds = ElapsedMilliseconds(start);
+
+	// 加法混合，粒子之间不需要排序
+	GLCALL(glEnable(GL_BLEND));
+	GLCALL(glBlendFunc(GL_ONE, GL_ONE));
+
+	m_Shader->Bind();
+	m_Shader->SetUniformMat4f("u_MVP", viewProjection);
+	m_Shader->SetUniform1f("u_Size", settings.Size);
+	m_VAO->Bind();
+	GLCALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count));
+	m_VAO->UnBind();
+
+	GLCALL(glDisable(GL_BLEND));
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+#include "glm/glm.hpp"
+
+class VertexArray;
+class VertexBuffer;
+class Shader;
+class ThreadPool;
+
+struct ParticleEmitterSettings
+{
+	glm::vec2 Position = glm::vec2(0.f);
+	float Direction = 1.5707963f;   // 发射方向（弧度）
+	float Spread = 1.2f;            // 方向的随机范围（弧度）
+	float Speed = 400.f;
+	float Lifetime = 2.f;           // 实际寿命在 [0.5, 1] * Lifetime 之间随机
+	float Gravity = -300.f;
+	float Drag = 0.4f;              // 每秒速度衰减比例
+	float Size = 4.f;
+};
+
+struct ParticleStats
+{
+	unsigned int Alive = 0;
+	unsigned int Emitted = 0;
+	unsigned int Removed = 0;
+	double SimulateMilliseconds = 0.0;
+	double CompactMilliseconds = 0.0;
+	double EmitMilliseconds = 0.0;
+	double UploadMilliseconds = 0.0;
+};
+
+// SoA 粒子池：每个属性一个连续数组，模拟内核一次处理 4 个粒子，按块分发到线程池
+class ParticlePool
+{
+public:
+	ParticlePool(unsigned int capacity);
+
+	inline unsigned int GetCount() const { return m_Count; }
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+
+	void Emit(unsigned int count, const ParticleEmitterSettings& settings, std::mt19937& rng);
+	// 交换删除：死亡的粒子用最后一个粒子填补，数组始终保持紧凑；返回删除的数量
+	unsigned int Compact();
+	void Simulate(unsigned int begin, unsigned int end, float deltaTime, const ParticleEmitterSettings& settings, bool useSIMD);
+
+public:
+	std::vector<float> PositionX, PositionY;
+	std::vector<float> VelocityX, VelocityY;
+	std::vector<float> Life, MaxLife;
+
+private:
+	unsigned int m_Count;
+	unsigned int m_Capacity;
+};
+
+// CPU 模拟的粒子系统，实例化绘制：一个四边形 x 粒子数
+class ParticleSystem
+{
+public:
+	ParticleSystem(unsigned int capacity);
+	~ParticleSystem();
+
+	void Update(float deltaTime, const ParticleEmitterSettings& settings);
+	void Render(const glm::mat4& viewProjection, const ParticleEmitterSettings& settings);
+
+	inline void SetUseSIMD(bool enable) { m_UseSIMD = enable; }
+	inline void SetUseThreads(bool enable) { m_UseThreads = enable; }
+	unsigned int GetThreadCount() const;
+	inline unsigned int GetCapacity() const { return m_Pool.GetCapacity(); }
+	inline const ParticleStats& GetStats() const { return m_Stats; }
+
+	static bool IsSIMDSupported();
+
+private:
+	ParticlePool m_Pool;
+	std::unique_ptr<ThreadPool> m_ThreadPool;
+	std::mt19937 m_Random;
+	float m_EmitAccumulator;
+	bool m_UseSIMD;
+	bool m_UseThreads;
+	ParticleStats m_Stats;
+
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_QuadVBO;
+	std::unique_ptr<VertexBuffer> m_InstanceVBO;
+	std::unique_ptr<Shader> m_Shader;
+};
@@ -0,0 +1,51 @@
+#include "PoolAllocator.h"
+
+#include <algorithm>
+#include <new>
+
+FixedPool::FixedPool(size_t blockSize, size_t blocksPerChunk)
+	: m_BlockSize(std::max(blockSize, sizeof(FreeBlock)))
+	, m_BlocksPerChunk(blocksPerChunk)
+	, m_FreeList(nullptr)
+	, m_UsedBlocks(0)
+{
+	// 对齐到指针大小，链表指针写在块的开头
+	m_BlockSize = (m_BlockSize + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+}
+
+FixedPool::~FixedPool()
+{
+	for (void* chunk : m_Chunks)
+		::operator delete(chunk);
+}
+
+void* FixedPool::Allocate()
+{
+	if (!m_FreeList)
+	{
+		char* chunk = (char*)::operator new(m_BlockSize * m_BlocksPerChunk);
+		m_Chunks.push_back(chunk);
+		for (size_t i = m_BlocksPerChunk; i > 0; i--)
+		{
+			FreeBlock* block = (FreeBlock*)(chunk + (i - 1) * m_BlockSize);
+			block->Next = m_FreeList;
+			m_FreeList = block;
+		}
+	}
+
+	FreeBlock* block = m_FreeList;
+	m_FreeList = block->Next;
+	m_UsedBlocks++;
+	return block;
+}
+
+void FixedPool::Free(void* pointer)
+{
+	if (!pointer)
+		return;
+
+	FreeBlock* block = (FreeBlock*)pointer;
+	block->Next = m_FreeList;
+	m_FreeList = block;
+	m_UsedBlocks--;
+}
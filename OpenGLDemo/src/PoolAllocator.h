@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// 固定大小的内存块池：按块（chunk）向堆申请，释放的块放回空闲链表，稳定后不再访问堆
+class FixedPool
+{
+public:
+	FixedPool(size_t blockSize, size_t blocksPerChunk = 256);
+	~FixedPool();
+
+	FixedPool(const FixedPool&) = delete;
+	FixedPool& operator=(const FixedPool&) = delete;
+
+	void* Allocate();
+	void Free(void* pointer);
+
+	inline size_t GetBlockSize() const { return m_BlockSize; }
+	inline unsigned int GetUsedBlocks() const { return m_UsedBlocks; }
+	inline unsigned int GetChunkCount() const { return (unsigned int)m_Chunks.size(); }
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* Next;
+	};
+
+	size_t m_BlockSize;
+	size_t m_BlocksPerChunk;
+	FreeBlock* m_FreeList;
+	std::vector<void*> m_Chunks;
+	unsigned int m_UsedBlocks;
+};
+
+// STL 分配器：单个元素（如 unordered_map 的节点）从按类型共享的 FixedPool 分配，
+// 数组（如桶）仍然走堆。只能在单个线程中使用
+template<typename T>
+class PoolAllocator
+{
+public:
+	typedef T value_type;
+
+	PoolAllocator() {}
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>&) {}
+
+	T* allocate(size_t count)
+	{
+		if (count == 1)
+			return (T*)GetPool().Allocate();
+		return (T*)::operator new(count * sizeof(T));
+	}
+
+	void deallocate(T* pointer, size_t count)
+	{
+		if (count == 1)
+			GetPool().Free(pointer);
+		else
+			::operator delete(pointer);
+	}
+
+	static FixedPool& GetPool()
+	{
+		// 块至少能放下一个空闲链表指针，并保持 T 的对齐
+		static FixedPool pool((sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T));
+		return pool;
+	}
+
+	template<typename U>
+	bool operator==(const PoolAllocator<U>&) const { return true; }
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
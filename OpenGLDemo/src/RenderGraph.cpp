@@ -0,0 +1,577 @@
+#include "RenderGraph.h"
+
+#include "Renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+	struct FormatInfo
+	{
+		GLenum InternalFormat;
+		GLenum Format;
+		GLenum Type;
+		unsigned int BytesPerPixel;
+		bool Depth;
+	};
+
+	FormatInfo GetFormatInfo(RenderTargetFormat format)
+	{
+		switch (format)
+		{
+		case RenderTargetFormat::RGBA16F:           return { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8, false };
+		case RenderTargetFormat::R8:                return { GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1, false };
+		case RenderTargetFormat::Depth24Stencil8:   return { GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, 4, true };
+		default:                                    return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4, false };
+		}
+	}
+
+}
+
+void RenderGraph::MarkUse(ResourceNode& resource, int position)
+{
+	if (resource.FirstUse < 0)
+		resource.FirstUse = position;
+	resource.LastUse = position;
+}
+
+unsigned int RenderTargetDesc::GetBytes() const
+{
+	return (unsigned int)Width * (unsigned int)Height * GetFormatInfo(Format).BytesPerPixel;
+}
+
+unsigned int RenderGraphContext::GetTexture(RenderGraphResource resource) const
+{
+	int physical = m_Graph.GetResourcePhysicalIndex(resource.Index);
+	return physical >= 0 ? m_Graph.m_Physical[physical].RendererID : 0;
+}
+
+void RenderGraphContext::BindTexture(RenderGraphResource resource, unsigned int slot) const
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D, GetTexture(resource));
+}
+
+RenderGraphResource RenderGraphPassBuilder::Read(RenderGraphResource resource)
+{
+	if (resource.IsValid())
+		m_Graph.m_Passes[m_Pass].Reads.push_back(resource.Index);
+	return resource;
+}
+
+RenderGraphResource RenderGraphPassBuilder::Write(RenderGraphResource resource)
+{
+	if (!resource.IsValid())
+		return resource;
+
+	m_Graph.m_Passes[m_Pass].Writes.push_back(resource.Index);
+	m_Graph.m_Resources[resource.Index].Writers.push_back(m_Pass);
+	// 写入默认帧缓冲的 pass 是最终输出，不能裁剪
+	if (m_Graph.m_Resources[resource.Index].Imported)
+		m_Graph.m_Passes[m_Pass].SideEffect = true;
+	return resource;
+}
+
+void RenderGraphPassBuilder::SetSideEffect()
+{
+	m_Graph.m_Passes[m_Pass].SideEffect = true;
+}
+
+void RenderGraphPassBuilder::SetExecute(std::function<void(RenderGraphContext&)> execute)
+{
+	m_Graph.m_Passes[m_Pass].Execute = std::move(execute);
+}
+
+RenderGraph::RenderGraph()
+	: m_Aliasing(true)
+	, m_Invalidation(true)
+	, m_Compiled(false)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	DestroyFramebuffers();
+	for (const PhysicalTexture& texture : m_Physical)
+		glDeleteTextures(1, &texture.RendererID);
+}
+
+void RenderGraph::Reset()
+{
+	DestroyFramebuffers();
+	m_Resources.clear();
+	m_Passes.clear();
+	m_Order.clear();
+	m_Compiled = false;
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderTargetDesc& desc)
+{
+	ResourceNode node;
+	node.Name = name;
+	node.Desc = desc;
+	node.Imported = false;
+	node.RefCount = 0;
+	node.FirstUse = -1;
+	node.LastUse = -1;
+	node.Physical = -1;
+	m_Resources.push_back(node);
+
+	RenderGraphResource resource;
+	resource.Index = (unsigned int)m_Resources.size() - 1;
+	return resource;
+}
+
+RenderGraphResource RenderGraph::ImportBackbuffer(const std::string& name, int width, int height)
+{
+	RenderTargetDesc desc;
+	desc.Width = width;
+	desc.Height = height;
+	RenderGraphResource resource = CreateTexture(name, desc);
+	m_Resources[resource.Index].Imported = true;
+	return resource;
+}
+
+RenderGraphPassBuilder RenderGraph::AddPass(const std::string& name)
+{
+	PassNode node;
+	node.Name = name;
+	node.SideEffect = false;
+	node.Culled = false;
+	node.RefCount = 0;
+	node.Framebuffer = 0;
+	node.Width = 0;
+	node.Height = 0;
+	m_Passes.push_back(node);
+	m_Compiled = false;
+	return RenderGraphPassBuilder(*this, (unsigned int)m_Passes.size() - 1);
+}
+
+bool RenderGraph::Compile()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	DestroyFramebuffers();
+	m_Compiled = false;
+	m_Stats = RenderGraphStats();
+
+	CullPasses();
+	if (!SortPasses() || !AllocateResources() || !CreateFramebuffers())
+		return false;
+
+	m_Stats.Passes = (unsigned int)m_Order.size();
+	m_Stats.CulledPasses = (unsigned int)(m_Passes.size() - m_Order.size());
+	m_Stats.CompileMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	m_Compiled = true;
+	return true;
+}
+
+void RenderGraph::CullPasses()
+{
+	for (ResourceNode& resource : m_Resources)
+	{
+		resource.RefCount = 0;
+		resource.FirstUse = -1;
+		resource.LastUse = -1;
+		resource.Physical = -1;
+	}
+	for (PassNode& pass : m_Passes)
+	{
+		pass.Culled = false;
+		pass.RefCount = (unsigned int)pass.Writes.size();
+		for (unsigned int read : pass.Reads)
+			m_Resources[read].RefCount++;
+	}
+
+	// 从没有读者的资源开始反向传播：写它的 pass 的输出都没人用时裁剪掉，并释放它读取的资源
+	std::vector<unsigned int> unused;
+	for (unsigned int i = 0; i < m_Resources.size(); i++)
+	{
+		if (m_Resources[i].RefCount == 0 && !m_Resources[i].Imported)
+			unused.push_back(i);
+	}
+
+	while (!unused.empty())
+	{
+		unsigned int resource = unused.back();
+		unused.pop_back();
+
+		for (unsigned int writer : m_Resources[resource].Writers)
+		{
+			PassNode& pass = m_Passes[writer];
+			if (pass.Culled || pass.SideEffect || --pass.RefCount > 0)
+				continue;
+
+			pass.Culled = true;
+			for (unsigned int read : pass.Reads)
+			{
+				if (--m_Resources[read].RefCount == 0 && !m_Resources[read].Imported)
+					unused.push_back(read);
+			}
+		}
+	}
+
+	// 没有输出也没有副作用的 pass 同样没有意义
+	for (PassNode& pass : m_Passes)
+	{
+		if (pass.Writes.empty() && !pass.SideEffect)
+			pass.Culled = true;
+	}
+}
+
+bool RenderGraph::SortPasses()
+{
+	// 依赖：读取者在写入者之后；同一资源的多个写入者保持添加顺序
+	unsigned int passCount = (unsigned int)m_Passes.size();
+	std::vector<std::vector<unsigned int>> dependents(passCount);
+	std::vector<unsigned int> inDegree(passCount, 0);
+
+	auto addEdge = [&](unsigned int from, unsigned int to)
+	{
+		if (from == to || m_Passes[from].Culled || m_Passes[to].Culled)
+			return;
+		if (std::find(dependents[from].begin(), dependents[from].end(), to) != dependents[from].end())
+			return;
+		dependents[from].push_back(to);
+		inDegree[to]++;
+	};
+
+	for (unsigned int p = 0; p < passCount; p++)
+	{
+		const PassNode& pass = m_Passes[p];
+		if (pass.Culled)
+			continue;
+
+		for (unsigned int read : pass.Reads)
+		{
+			const ResourceNode& resource = m_Resources[read];
+			// 读取在它之前添加的写入者的结果；如果都在之后添加，则依赖全部写入者
+			bool earlierWriter = false;
+			for (unsigned int writer : resource.Writers)
+				earlierWriter |= writer < p && !m_Passes[writer].Culled;
+			bool anyWriter = false;
+			for (unsigned int writer : resource.Writers)
+			{
+				if (m_Passes[writer].Culled || (earlierWriter && writer > p))
+					continue;
+				addEdge(writer, p);
+				anyWriter = true;
+			}
+			if (!anyWriter && !resource.Imported)
+				std::cout << "Warring:: render graph pass " << pass.Name << " reads " << resource.Name << " which is never written" << std::endl;
+		}
+	}
+	for (const ResourceNode& resource : m_Resources)
+	{
+		for (size_t i = 1; i < resource.Writers.size(); i++)
+			addEdge(resource.Writers[i - 1], resource.Writers[i]);
+	}
+
+	// Kahn 拓扑排序，可选的 pass 中总是取添加顺序最早的，结果稳定
+	m_Order.clear();
+	std::vector<bool> emitted(passCount, false);
+	unsigned int expected = 0;
+	for (const PassNode& pass : m_Passes)
+		expected += pass.Culled ? 0 : 1;
+
+	while (m_Order.size() < expected)
+	{
+		unsigned int next = passCount;
+		for (unsigned int p = 0; p < passCount; p++)
+		{
+			if (!m_Passes[p].Culled && !emitted[p] && inDegree[p] == 0)
+			{
+				next = p;
+				break;
+			}
+		}
+		if (next == passCount)
+		{
+			std::cout << "Failed to compile render graph: passes have a cyclic dependency" << std::endl;
+			return false;
+		}
+
+		emitted[next] = true;
+		m_Order.push_back(next);
+		for (unsigned int dependent : dependents[next])
+			inDegree[dependent]--;
+	}
+	return true;
+}
+
+bool RenderGraph::AllocateResources()
+{
+	for (unsigned int position = 0; position < m_Order.size(); position++)
+	{
+		const PassNode& pass = m_Passes[m_Order[position]];
+		for (unsigned int read : pass.Reads)
+			MarkUse(m_Resources[read], (int)position);
+		for (unsigned int write : pass.Writes)
+			MarkUse(m_Resources[write], (int)position);
+	}
+
+	// 按首次使用的顺序分配，先结束生命周期的纹理可以被后面的资源复用
+	std::vector<unsigned int> transient;
+	for (unsigned int i = 0; i < m_Resources.size(); i++)
+	{
+		if (!m_Resources[i].Imported && m_Resources[i].FirstUse >= 0)
+			transient.push_back(i);
+	}
+	std::sort(transient.begin(), transient.end(), [this](unsigned int a, unsigned int b)
+	{
+		return m_Resources[a].FirstUse < m_Resources[b].FirstUse;
+	});
+
+	for (PhysicalTexture& texture : m_Physical)
+		texture.Used = false;
+
+	for (unsigned int index : transient)
+	{
+		ResourceNode& resource = m_Resources[index];
+		if (resource.Desc.Width <= 0 || resource.Desc.Height <= 0)
+		{
+			std::cout << "Failed to compile render graph: " << resource.Name << " has an invalid size" << std::endl;
+			return false;
+		}
+		resource.Physical = AcquirePhysical(resource.Desc, resource.FirstUse, resource.LastUse);
+		m_Stats.TransientTextures++;
+		m_Stats.TransientBytes += resource.Desc.GetBytes();
+	}
+
+	// 释放本次没有用到的池中纹理，并重新编号
+	std::vector<int> remap(m_Physical.size(), -1);
+	std::vector<PhysicalTexture> kept;
+	for (size_t i = 0; i < m_Physical.size(); i++)
+	{
+		if (m_Physical[i].Used)
+		{
+			remap[i] = (int)kept.size();
+			kept.push_back(m_Physical[i]);
+			m_Stats.PhysicalBytes += m_Physical[i].Desc.GetBytes();
+		}
+		else
+		{
+			glDeleteTextures(1, &m_Physical[i].RendererID);
+		}
+	}
+	m_Physical.swap(kept);
+	for (unsigned int index : transient)
+		m_Resources[index].Physical = remap[m_Resources[index].Physical];
+	m_Stats.PhysicalTextures = (unsigned int)m_Physical.size();
+	return true;
+}
+
+int RenderGraph::AcquirePhysical(const RenderTargetDesc& desc, int firstUse, int lastUse)
+{
+	int found = -1;
+	for (size_t i = 0; i < m_Physical.size() && found < 0; i++)
+	{
+		PhysicalTexture& texture = m_Physical[i];
+		if (!(texture.Desc == desc))
+			continue;
+		// 池中还没分配的纹理总可以用；已经分配的只有在上一个使用者结束后才能复用
+		if (!texture.Used || (m_Aliasing && texture.FreeAfter < firstUse))
+			found = (int)i;
+	}
+
+	if (found < 0)
+	{
+		FormatInfo info = GetFormatInfo(desc.Format);
+		PhysicalTexture texture;
+		texture.Desc = desc;
+		glGenTextures(1, &texture.RendererID);
+		glBindTexture(GL_TEXTURE_2D, texture.RendererID);
+		GLenum filter = info.Depth ? GL_NEAREST : GL_LINEAR;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, info.InternalFormat, desc.Width, desc.Height, 0, info.Format, info.Type, nullptr));
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		m_Physical.push_back(texture);
+		found = (int)m_Physical.size() - 1;
+	}
+
+	m_Physical[found].Used = true;
+	m_Physical[found].FreeAfter = lastUse;
+	return found;
+}
+
+bool RenderGraph::CreateFramebuffers()
+{
+	GLint lastFramebuffer;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &lastFramebuffer);
+
+	for (unsigned int position = 0; position < m_Order.size(); position++)
+	{
+		PassNode& pass = m_Passes[m_Order[position]];
+		pass.Framebuffer = 0;
+		pass.Width = 0;
+		pass.Height = 0;
+		pass.DiscardBefore.clear();
+		pass.DiscardAfter.clear();
+		pass.ReleaseTextures.clear();
+
+		bool backbuffer = false, transient = false;
+		for (unsigned int write : pass.Writes)
+		{
+			const ResourceNode& resource = m_Resources[write];
+			if (resource.Imported)
+				backbuffer = true;
+			else
+				transient = true;
+			if (pass.Width == 0)
+			{
+				pass.Width = resource.Desc.Width;
+				pass.Height = resource.Desc.Height;
+			}
+			else if (pass.Width != resource.Desc.Width || pass.Height != resource.Desc.Height)
+			{
+				std::cout << "Failed to compile render graph: pass " << pass.Name << " writes targets of different sizes" << std::endl;
+				return false;
+			}
+		}
+		if (backbuffer && transient)
+		{
+			std::cout << "Failed to compile render graph: pass " << pass.Name << " writes both the backbuffer and transient targets" << std::endl;
+			return false;
+		}
+
+		// 作为输入最后一次使用的纹理，pass 结束后内容不再需要
+		for (unsigned int read : pass.Reads)
+		{
+			const ResourceNode& resource = m_Resources[read];
+			bool written = std::find(pass.Writes.begin(), pass.Writes.end(), read) != pass.Writes.end();
+			if (!resource.Imported && !written && resource.LastUse == (int)position)
+				pass.ReleaseTextures.push_back(m_Physical[resource.Physical].RendererID);
+		}
+
+		if (!transient)
+			continue;
+
+		GLCALL(glGenFramebuffers(1, &pass.Framebuffer));
+		GLCALL(glBindFramebuffer(GL_FRAMEBUFFER, pass.Framebuffer));
+
+		GLenum drawBuffers[8];
+		unsigned int colorCount = 0;
+		for (unsigned int write : pass.Writes)
+		{
+			const ResourceNode& resource = m_Resources[write];
+			GLenum attachment;
+			if (GetFormatInfo(resource.Desc.Format).Depth)
+			{
+				attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+			}
+			else
+			{
+				if (colorCount == 8)
+				{
+					std::cout << "Failed to compile render graph: pass " << pass.Name << " writes more than 8 color targets" << std::endl;
+					return false;
+				}
+				attachment = GL_COLOR_ATTACHMENT0 + colorCount;
+				drawBuffers[colorCount++] = attachment;
+			}
+			GLCALL(glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, m_Physical[resource.Physical].RendererID, 0));
+
+			// pass 需要完整覆盖首次写入的目标（清屏或全屏绘制），之前的内容可以丢弃
+			if (resource.FirstUse == (int)position)
+				pass.DiscardBefore.push_back(attachment);
+			if (resource.LastUse == (int)position)
+				pass.DiscardAfter.push_back(attachment);
+		}
+		if (colorCount > 0)
+		{
+			GLCALL(glDrawBuffers(colorCount, drawBuffers));
+		}
+		else
+		{
+			GLCALL(glDrawBuffer(GL_NONE));
+		}
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "Failed to compile render graph: framebuffer of pass " << pass.Name << " is incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+			glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+			return false;
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+	return true;
+}
+
+void RenderGraph::DestroyFramebuffers()
+{
+	for (PassNode& pass : m_Passes)
+	{
+		if (pass.Framebuffer)
+			glDeleteFramebuffers(1, &pass.Framebuffer);
+		pass.Framebuffer = 0;
+	}
+}
+
+void RenderGraph::Execute()
+{
+	if (!m_Compiled)
+		return;
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	// 写入 backbuffer 的 pass 画到调用时绑定的帧缓冲（按需渲染时是常驻画布）
+	GLint backbuffer;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &backbuffer);
+
+	bool invalidate = m_Invalidation && IsInvalidationSupported();
+	m_Stats.InvalidatedAttachments = 0;
+
+	RenderGraphContext context(*this);
+	for (unsigned int index : m_Order)
+	{
+		PassNode& pass = m_Passes[index];
+		glBindFramebuffer(GL_FRAMEBUFFER, pass.Framebuffer ? pass.Framebuffer : (GLuint)backbuffer);
+		glViewport(0, 0, pass.Width, pass.Height);
+
+		if (invalidate && !pass.DiscardBefore.empty())
+		{
+			glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)pass.DiscardBefore.size(), pass.DiscardBefore.data());
+			m_Stats.InvalidatedAttachments += (unsigned int)pass.DiscardBefore.size();
+		}
+
+		context.m_Width = pass.Width;
+		context.m_Height = pass.Height;
+		if (pass.Execute)
+			pass.Execute(context);
+
+		if (invalidate)
+		{
+			if (!pass.DiscardAfter.empty())
+			{
+				glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)pass.DiscardAfter.size(), pass.DiscardAfter.data());
+				m_Stats.InvalidatedAttachments += (unsigned int)pass.DiscardAfter.size();
+			}
+			for (unsigned int texture : pass.ReleaseTextures)
+				glInvalidateTexImage(texture, 0);
+			m_Stats.InvalidatedAttachments += (unsigned int)pass.ReleaseTextures.size();
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, backbuffer);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+bool RenderGraph::IsInvalidationSupported()
+{
+	return GLEW_VERSION_4_3 || GLEW_ARB_invalidate_subdata;
+}
+
+int RenderGraph::GetResourcePhysicalIndex(unsigned int resource) const
+{
+	if (resource >= m_Resources.size())
+		return -1;
+	return m_Resources[resource].Physical;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class RenderTargetFormat
+{
+	RGBA8,
+	RGBA16F,
+	R8,
+	Depth24Stencil8
+};
+
+struct RenderTargetDesc
+{
+	int Width = 0;
+	int Height = 0;
+	RenderTargetFormat Format = RenderTargetFormat::RGBA8;
+
+	inline bool operator==(const RenderTargetDesc& other) const { return Width == other.Width && Height == other.Height && Format == other.Format; }
+	unsigned int GetBytes() const;
+};
+
+// 图中资源的句柄，只在创建它的 RenderGraph 中有效
+struct RenderGraphResource
+{
+	unsigned int Index = ~0u;
+
+	inline bool IsValid() const { return Index != ~0u; }
+};
+
+struct RenderGraphStats
+{
+	unsigned int Passes = 0;
+	unsigned int CulledPasses = 0;
+	unsigned int TransientTextures = 0;     // 图中声明的临时纹理（裁剪后仍被使用的）
+	unsigned int PhysicalTextures = 0;      // 实际创建的 GL 纹理
+	unsigned int TransientBytes = 0;        // 每个临时纹理单独分配时的显存
+	unsigned int PhysicalBytes = 0;         // 复用后实际占用的显存，即临时资源的峰值
+	unsigned int InvalidatedAttachments = 0;
+	double CompileMilliseconds = 0.0;
+};
+
+class RenderGraph;
+
+// 执行 pass 时传入：帧缓冲和视口已经按 pass 的输出设置好
+class RenderGraphContext
+{
+public:
+	unsigned int GetTexture(RenderGraphResource resource) const;
+	void BindTexture(RenderGraphResource resource, unsigned int slot) const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+
+private:
+	friend class RenderGraph;
+	RenderGraphContext(const RenderGraph& graph) : m_Graph(graph), m_Width(0), m_Height(0) {}
+
+	const RenderGraph& m_Graph;
+	int m_Width, m_Height;
+};
+
+// AddPass 返回，用来声明 pass 读写的资源
+class RenderGraphPassBuilder
+{
+public:
+	RenderGraphResource Read(RenderGraphResource resource);
+	RenderGraphResource Write(RenderGraphResource resource);
+	// 标记为有副作用（例如读回数据），即使输出没有被使用也不会被裁剪
+	void SetSideEffect();
+	void SetExecute(std::function<void(RenderGraphContext&)> execute);
+
+private:
+	friend class RenderGraph;
+	RenderGraphPassBuilder(RenderGraph& graph, unsigned int pass) : m_Graph(graph), m_Pass(pass) {}
+
+	RenderGraph& m_Graph;
+	unsigned int m_Pass;
+};
+
+// 帧渲染图：pass 声明读写的资源，Compile 裁剪没有用到输出的 pass、排序、分配临时纹理，
+// 生命周期不重叠且描述相同的临时纹理共用一个 GL 纹理。图只在设置变化时重建，每帧只调用 Execute
+class RenderGraph
+{
+public:
+	RenderGraph();
+	~RenderGraph();
+
+	// 清空 pass 和资源，GL 纹理保留在池中供下一次 Compile 复用
+	void Reset();
+
+	RenderGraphResource CreateTexture(const std::string& name, const RenderTargetDesc& desc);
+	// 默认帧缓冲，写入它的 pass 是裁剪的起点
+	RenderGraphResource ImportBackbuffer(const std::string& name, int width, int height);
+	RenderGraphPassBuilder AddPass(const std::string& name);
+
+	bool Compile();
+	void Execute();
+
+	// 关闭后每个临时资源单独占用一个纹理，用于比较显存
+	inline void SetAliasing(bool enabled) { m_Aliasing = enabled; }
+	// 在首次写入前和最后一次使用后丢弃内容（glInvalidateFramebuffer），分块渲染的 GPU 可以省掉读入/写回
+	inline void SetInvalidation(bool enabled) { m_Invalidation = enabled; }
+	static bool IsInvalidationSupported();
+
+	inline bool IsCompiled() const { return m_Compiled; }
+	inline const RenderGraphStats& GetStats() const { return m_Stats; }
+
+	// 调试显示用
+	unsigned int GetPassCount() const { return (unsigned int)m_Passes.size(); }
+	const std::string& GetPassName(unsigned int pass) const { return m_Passes[pass].Name; }
+	bool IsPassCulled(unsigned int pass) const { return m_Passes[pass].Culled; }
+	// 按执行顺序排列的 pass 序号
+	const std::vector<unsigned int>& GetExecutionOrder() const { return m_Order; }
+	unsigned int GetResourceCount() const { return (unsigned int)m_Resources.size(); }
+	const std::string& GetResourceName(unsigned int resource) const { return m_Resources[resource].Name; }
+	// 分配到的物理纹理序号，被裁剪或导入的资源返回 -1
+	int GetResourcePhysicalIndex(unsigned int resource) const;
+
+private:
+	struct ResourceNode
+	{
+		std::string Name;
+		RenderTargetDesc Desc;
+		bool Imported;
+		std::vector<unsigned int> Writers;
+		unsigned int RefCount;      // 读取它的未裁剪 pass 数
+		int FirstUse, LastUse;      // 执行顺序中的位置
+		int Physical;
+	};
+
+	struct PassNode
+	{
+		std::string Name;
+		std::vector<unsigned int> Reads;
+		std::vector<unsigned int> Writes;
+		std::function<void(RenderGraphContext&)> Execute;
+		bool SideEffect;
+		bool Culled;
+		unsigned int RefCount;      // 被使用的输出数
+
+		unsigned int Framebuffer;
+		int Width, Height;
+		std::vector<unsigned int> DiscardBefore;    // 附件，首次写入前丢弃
+		std::vector<unsigned int> DiscardAfter;     // 附件，最后一次使用后丢弃
+		std::vector<unsigned int> ReleaseTextures;  // 作为输入最后一次使用的纹理
+	};
+
+	struct PhysicalTexture
+	{
+		unsigned int RendererID;
+		RenderTargetDesc Desc;
+		bool Used;      // 本次 Compile 是否被分配
+		int FreeAfter;  // 最后一个使用者在执行顺序中的位置，之后可以被复用
+	};
+
+	void CullPasses();
+	bool SortPasses();
+	bool AllocateResources();
+	bool CreateFramebuffers();
+	void DestroyFramebuffers();
+	static void MarkUse(ResourceNode& resource, int position);
+	int AcquirePhysical(const RenderTargetDesc& desc, int firstUse, int lastUse);
+
+private:
+	friend class RenderGraphContext;
+	friend class RenderGraphPassBuilder;
+
+	std::vector<ResourceNode> m_Resources;
+	std::vector<PassNode> m_Passes;
+	std::vector<unsigned int> m_Order;
+	std::vector<PhysicalTexture> m_Physical;
+
+	bool m_Aliasing;
+	bool m_Invalidation;
+	bool m_Compiled;
+	RenderGraphStats m_Stats;
+};
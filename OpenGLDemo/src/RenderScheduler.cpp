@@ -0,0 +1,389 @@
+#include "RenderScheduler.h"
+
+#include "Renderer.h"
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <limits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+	// 没有任何待处理的事情时最长的等待时间，醒来后只更新统计
+	const double MaxIdleTimeout = 1.0;
+	const int SettleFrameCount = 2;
+	const double StatsWindow = 1.0;
+
+	// 进程（所有线程）累计的 CPU 时间
+	double GetProcessCpuSeconds()
+	{
+#ifdef _WIN32
+		FILETIME creation, exit, kernel, user;
+		if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+			return 0.0;
+		ULARGE_INTEGER k, u;
+		k.LowPart = kernel.dwLowDateTime;
+		k.HighPart = kernel.dwHighDateTime;
+		u.LowPart = user.dwLowDateTime;
+		u.HighPart = user.dwHighDateTime;
+		return (double)(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return (double)std::clock() / CLOCKS_PER_SEC;
+		return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+	}
+
+}
+
+RenderScheduler& RenderScheduler::Get()
+{
+	static RenderScheduler scheduler;
+	return scheduler;
+}
+
+RenderScheduler::RenderScheduler()
+	: m_OnDemand(false)
+	, m_PartialRedraw(true)
+	, m_LastPolicy(RedrawPolicy::Continuous)
+	, m_FullDamage(true)
+	, m_HasRectDamage(false)
+	, m_Input(false)
+	, m_SettleFrames(0)
+	, m_WakeTime(std::numeric_limits<double>::infinity())
+	, m_ThreadWake(false)
+	, m_RenderContent(true)
+	, m_FullRedraw(true)
+	, m_UseCanvas(false)
+	, m_Width(0)
+	, m_Height(0)
+	, m_Canvas(0)
+	, m_CanvasColor(0)
+	, m_CanvasDepth(0)
+	, m_CanvasWidth(0)
+	, m_CanvasHeight(0)
+	, m_CanvasValid(false)
+	, m_WindowStart(0.0)
+	, m_WindowCpuStart(0.0)
+	, m_WindowFrames(0)
+	, m_WindowWakeups(0)
+{
+}
+
+RenderScheduler::~RenderScheduler()
+{
+}
+
+void RenderScheduler::SetOnDemand(bool enabled)
+{
+	if (m_OnDemand == enabled)
+		return;
+
+	m_OnDemand = enabled;
+	Invalidate();
+	ResetModeStats(glfwGetTime());
+}
+
+void RenderScheduler::SetPartialRedraw(bool enabled)
+{
+	if (m_PartialRedraw == enabled)
+		return;
+
+	m_PartialRedraw = enabled;
+	Invalidate();
+}
+
+void RenderScheduler::Invalidate()
+{
+	m_FullDamage = true;
+}
+
+void RenderScheduler::Invalidate(int x, int y, int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (!m_HasRectDamage)
+	{
+		m_Damage.X = x;
+		m_Damage.Y = y;
+		m_Damage.Width = width;
+		m_Damage.Height = height;
+		m_HasRectDamage = true;
+		return;
+	}
+
+	int x1 = std::max(m_Damage.X + m_Damage.Width, x + width);
+	int y1 = std::max(m_Damage.Y + m_Damage.Height, y + height);
+	m_Damage.X = std::min(m_Damage.X, x);
+	m_Damage.Y = std::min(m_Damage.Y, y);
+	m_Damage.Width = x1 - m_Damage.X;
+	m_Damage.Height = y1 - m_Damage.Y;
+}
+
+void RenderScheduler::NotifyInput()
+{
+	m_Input = true;
+}
+
+void RenderScheduler::WakeAfter(double seconds)
+{
+	m_WakeTime = std::min(m_WakeTime, glfwGetTime() + std::max(seconds, 0.0));
+}
+
+void RenderScheduler::WakeFromThread()
+{
+	m_ThreadWake = true;
+	glfwPostEmptyEvent();
+}
+
+double RenderScheduler::GetWaitTimeout(double now) const
+{
+	if (m_FullDamage || m_HasRectDamage || m_Input || m_SettleFrames > 0 || m_ThreadWake)
+		return 0.0;
+	if (m_LastPolicy == RedrawPolicy::Continuous)
+		return 0.0;
+	return std::min(std::max(m_WakeTime - now, 0.0), MaxIdleTimeout);
+}
+
+void RenderScheduler::WaitForEvents()
+{
+	if (!m_OnDemand)
+	{
+		glfwPollEvents();
+	}
+	else
+	{
+		double timeout = GetWaitTimeout(glfwGetTime());
+		if (timeout > 0.0)
+			glfwWaitEventsTimeout(timeout);
+		else
+			glfwPollEvents();
+	}
+
+	// 醒来后由 OnUpdate 重新请求定时唤醒
+	m_WakeTime = std::numeric_limits<double>::infinity();
+	m_ThreadWake = false;
+	UpdateModeStats(glfwGetTime());
+}
+
+bool RenderScheduler::BeginFrame(RedrawPolicy policy, int width, int height)
+{
+	m_LastPolicy = policy;
+	if (width != m_Width || height != m_Height)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_FullDamage = true;
+	}
+
+	bool input = m_Input;
+	bool ui = input || m_SettleFrames > 0;
+	m_UseCanvas = m_OnDemand && m_PartialRedraw;
+
+	if (!m_OnDemand)
+	{
+		m_RenderContent = true;
+	}
+	else
+	{
+		m_RenderContent = m_FullDamage || m_HasRectDamage || policy == RedrawPolicy::Continuous
+			|| (policy == RedrawPolicy::OnInput && ui);
+		if (!m_RenderContent && !ui)
+		{
+			m_Stats.IdleWakeups++;
+			m_WindowWakeups++;
+			return false;
+		}
+	}
+
+	// 不使用画布时后缓冲在交换后内容未定义，只要绘制就必须完整重绘
+	if (!m_UseCanvas || !m_CanvasValid || m_CanvasWidth != width || m_CanvasHeight != height)
+		m_RenderContent = true;
+	m_FullRedraw = !m_UseCanvas || !m_CanvasValid || m_FullDamage || policy != RedrawPolicy::Explicit
+		|| m_CanvasWidth != width || m_CanvasHeight != height;
+
+	if (m_FullRedraw || !m_HasRectDamage)
+	{
+		m_Bounds = DamageRect();
+		m_Bounds.Width = width;
+		m_Bounds.Height = height;
+	}
+	else
+	{
+		int x0 = std::max(m_Damage.X, 0), y0 = std::max(m_Damage.Y, 0);
+		int x1 = std::min(m_Damage.X + m_Damage.Width, width), y1 = std::min(m_Damage.Y + m_Damage.Height, height);
+		m_Bounds.X = x0;
+		m_Bounds.Y = y0;
+		m_Bounds.Width = std::max(x1 - x0, 0);
+		m_Bounds.Height = std::max(y1 - y0, 0);
+	}
+
+	if (input)
+		m_SettleFrames = SettleFrameCount;
+	else if (m_SettleFrames > 0)
+		m_SettleFrames--;
+
+	// 本帧已经取走了积累的变化，OnRender 和 UI 中新的 Invalidate 留给下一帧
+	m_Input = false;
+	m_FullDamage = false;
+	m_HasRectDamage = false;
+
+	m_Stats.ActiveFrames++;
+	m_WindowFrames++;
+	if (m_RenderContent)
+	{
+		m_Stats.ContentFrames++;
+		m_Stats.LastDamage = m_Bounds;
+		if (!m_FullRedraw)
+			m_Stats.PartialFrames++;
+	}
+	return true;
+}
+
+void RenderScheduler::BeginContent()
+{
+	if (!m_UseCanvas)
+	{
+		m_CanvasValid = false;
+		return;
+	}
+
+	if (!EnsureCanvas(m_Width, m_Height))
+	{
+		m_UseCanvas = false;
+		return;
+	}
+
+	GLCALL(glBindFramebuffer(GL_FRAMEBUFFER, m_Canvas));
+	if (!m_FullRedraw)
+	{
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(m_Bounds.X, m_Bounds.Y, m_Bounds.Width, m_Bounds.Height);
+	}
+}
+
+void RenderScheduler::EndContent()
+{
+	glDisable(GL_SCISSOR_TEST);
+	if (m_UseCanvas)
+	{
+		m_CanvasValid = true;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+void RenderScheduler::Present()
+{
+	if (!m_UseCanvas || !m_CanvasValid)
+		return;
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Canvas);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	GLCALL(glBlitFramebuffer(0, 0, m_CanvasWidth, m_CanvasHeight, 0, 0, m_CanvasWidth, m_CanvasHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderScheduler::EndFrame()
+{
+	// 不使用画布的帧没有更新画布，之后再开启时需要完整重绘
+	if (!m_UseCanvas)
+		m_CanvasValid = false;
+}
+
+void RenderScheduler::Shutdown()
+{
+	DestroyCanvas();
+}
+
+bool RenderScheduler::EnsureCanvas(int width, int height)
+{
+	if (m_Canvas && m_CanvasWidth == width && m_CanvasHeight == height)
+		return true;
+
+	DestroyCanvas();
+	if (width <= 0 || height <= 0)
+		return false;
+
+	GLCALL(glGenTextures(1, &m_CanvasColor));
+	glBindTexture(GL_TEXTURE_2D, m_CanvasColor);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &m_CanvasDepth);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_CanvasDepth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLCALL(glGenFramebuffers(1, &m_Canvas));
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Canvas);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_CanvasColor, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_CanvasDepth);
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (!complete)
+	{
+		std::cout << "Failed to create redraw canvas, partial redraw is disabled" << std::endl;
+		DestroyCanvas();
+		m_PartialRedraw = false;
+		return false;
+	}
+
+	m_CanvasWidth = width;
+	m_CanvasHeight = height;
+	m_CanvasValid = false;
+	return true;
+}
+
+void RenderScheduler::DestroyCanvas()
+{
+	if (m_Canvas)
+		glDeleteFramebuffers(1, &m_Canvas);
+	if (m_CanvasColor)
+		glDeleteTextures(1, &m_CanvasColor);
+	if (m_CanvasDepth)
+		glDeleteRenderbuffers(1, &m_CanvasDepth);
+	m_Canvas = m_CanvasColor = m_CanvasDepth = 0;
+	m_CanvasWidth = m_CanvasHeight = 0;
+	m_CanvasValid = false;
+}
+
+void RenderScheduler::ResetModeStats(double now)
+{
+	m_WindowStart = now;
+	m_WindowCpuStart = GetProcessCpuSeconds();
+	m_WindowFrames = 0;
+	m_WindowWakeups = 0;
+}
+
+void RenderScheduler::UpdateModeStats(double now)
+{
+	if (m_WindowStart == 0.0)
+	{
+		ResetModeStats(now);
+		return;
+	}
+
+	double elapsed = now - m_WindowStart;
+	if (elapsed < StatsWindow)
+		return;
+
+	RenderModeStats& mode = m_OnDemand ? m_Stats.OnDemand : m_Stats.Continuous;
+	mode.Measured = true;
+	mode.CpuPercent = (GetProcessCpuSeconds() - m_WindowCpuStart) / elapsed * 100.0;
+	mode.FramesPerSecond = m_WindowFrames / elapsed;
+	mode.WakeupsPerSecond = m_WindowWakeups / elapsed;
+	ResetModeStats(now);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+
+// 测试场景的重绘方式
+enum class RedrawPolicy
+{
+	Continuous,     // 每帧都在变化（默认）
+	OnInput,        // 静态画面，只在有输入（UI 操作可能改变了参数）时重绘
+	Explicit        // 自己通过 RenderScheduler::Invalidate 报告变化的区域
+};
+
+// 帧缓冲像素坐标，左下角为原点
+struct DamageRect
+{
+	int X = 0, Y = 0;
+	int Width = 0, Height = 0;
+};
+
+struct RenderModeStats
+{
+	bool Measured = false;
+	double CpuPercent = 0.0;            // 进程 CPU 时间 / 墙上时间，100% 为一个核
+	double FramesPerSecond = 0.0;
+	double WakeupsPerSecond = 0.0;      // 醒来但没有变化、没有绘制的次数
+};
+
+struct RenderSchedulerStats
+{
+	unsigned long long ActiveFrames = 0;    // 绘制并交换的帧
+	unsigned long long IdleWakeups = 0;     // 醒来后没有绘制
+	unsigned long long ContentFrames = 0;   // 重新绘制了测试画面的帧（其余只重绘 UI）
+	unsigned long long PartialFrames = 0;   // 只重绘了损坏区域的帧
+	DamageRect LastDamage;
+	RenderModeStats Continuous;
+	RenderModeStats OnDemand;
+};
+
+// 按需渲染：输入、动画和异步任务报告变化，没有变化时主循环阻塞在 glfwWaitEventsTimeout 中。
+// 开启局部重绘时测试画面绘制到一个常驻的画布上，只用 scissor 重绘损坏的区域再复制到默认帧缓冲，
+// 因为交换之后后缓冲的内容是未定义的
+class RenderScheduler
+{
+public:
+	static RenderScheduler& Get();
+
+	void SetOnDemand(bool enabled);
+	inline bool IsOnDemand() const { return m_OnDemand; }
+	void SetPartialRedraw(bool enabled);
+	inline bool IsPartialRedraw() const { return m_PartialRedraw; }
+
+	// 整个测试画面需要重绘
+	void Invalidate();
+	// 只有这块区域需要重绘，多次调用取包围盒
+	void Invalidate(int x, int y, int width, int height);
+	// 输入事件：UI 需要重绘，OnInput 的测试画面也要重绘
+	void NotifyInput();
+	// 最晚在 seconds 秒后再执行一次 OnUpdate，用于定时更新；每次醒来后需要重新请求
+	void WakeAfter(double seconds);
+	// 动画：下一帧立刻继续
+	inline void RequestAnimationFrame() { WakeAfter(0.0); }
+	// 任意线程调用：唤醒等待中的主循环，结果在 OnUpdate 中处理
+	void WakeFromThread();
+
+	// 主循环：等待事件（连续模式下只是 glfwPollEvents）
+	void WaitForEvents();
+	// 没有任何变化时返回 false，跳过这一帧的绘制和交换
+	bool BeginFrame(RedrawPolicy policy, int width, int height);
+	inline bool ShouldRenderContent() const { return m_RenderContent; }
+	// 本帧测试画面重绘的区域，OnRender 期间已经设置了 scissor
+	inline const DamageRect& GetDamageBounds() const { return m_Bounds; }
+	inline bool IsFullRedraw() const { return m_FullRedraw; }
+	void BeginContent();
+	void EndContent();
+	// 使用画布时把它复制到默认帧缓冲，之后绘制 UI
+	void Present();
+	void EndFrame();
+	// 在销毁 GL 上下文之前调用，释放画布
+	void Shutdown();
+
+	inline const RenderSchedulerStats& GetStats() const { return m_Stats; }
+
+private:
+	RenderScheduler();
+	~RenderScheduler();
+
+	RenderScheduler(const RenderScheduler&) = delete;
+	RenderScheduler& operator=(const RenderScheduler&) = delete;
+
+	double GetWaitTimeout(double now) const;
+	void UpdateModeStats(double now);
+	void ResetModeStats(double now);
+	bool EnsureCanvas(int width, int height);
+	void DestroyCanvas();
+
+private:
+	bool m_OnDemand;
+	bool m_PartialRedraw;
+	RedrawPolicy m_LastPolicy;
+
+	// 积累的变化
+	bool m_FullDamage;
+	bool m_HasRectDamage;
+	DamageRect m_Damage;
+	bool m_Input;
+	int m_SettleFrames;         // 输入之后再多画几帧，ImGui 需要一帧处理悬停/松开等状态
+	double m_WakeTime;
+	std::atomic<bool> m_ThreadWake;
+
+	// 当前帧
+	bool m_RenderContent;
+	bool m_FullRedraw;
+	bool m_UseCanvas;
+	DamageRect m_Bounds;
+	int m_Width, m_Height;
+
+	unsigned int m_Canvas;
+	unsigned int m_CanvasColor;
+	unsigned int m_CanvasDepth;
+	int m_CanvasWidth, m_CanvasHeight;
+	bool m_CanvasValid;
+
+	// CPU 占用统计窗口
+	double m_WindowStart;
+	double m_WindowCpuStart;
+	unsigned long long m_WindowFrames;
+	unsigned long long m_WindowWakeups;
+
+	RenderSchedulerStats m_Stats;
+};
@@ -27,11 +27,11 @@ void Renderer::Draw(const VertexArray* va, const IndexBuffer* ib, const Shader*
     shader->Bind();
     va->Bind();
     ib->Bind();
-    GLCALL(glDrawElements(GL_TRIANGLES, ib->GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCALL(glDrawElements(GL_TRIANGLES, ib->GetCount(), ib->GetType(), nullptr));
 }
 
 void Renderer::Clear() const
 {
     glClearColor(0.f, 0.f, 0.f, 0.f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -1,27 +1,91 @@
 #include "Shader.h"
 
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <vector>
 
 #include "Renderer.h"
+#include "FrameArena.h"
+#include "MemoryTracker.h"
+#include "ShaderPreprocessor.h"
+
+static bool s_ParallelCompile = false;
 
 Shader::Shader(const std::string& filePath)
-	: m_FilePath(filePath)
-	, m_RendererID(0)
+	: m_RendererID(0)
+	, m_FilePath(filePath)
+	, m_VertexShader(0)
+	, m_FragmentShader(0)
+	, m_Finalized(false)
+	, m_Valid(false)
+{
+    MemoryTagScope tag(MemoryTag::Shader);
+    ShaderSource source = ShaderPreprocessor::Process(filePath);
+    m_Files = source.Files;
+    CreateShader(source.VertexSource, source.FragmentSource);
+    Finalize();
+}
+
+Shader::Shader(const std::string& filePath, const std::vector<std::string>& feedbackVaryings)
+	: m_RendererID(0)
+	, m_FilePath(filePath)
+	, m_VertexShader(0)
+	, m_FragmentShader(0)
+	, m_Finalized(false)
+	, m_Valid(false)
+{
+    MemoryTagScope tag(MemoryTag::Shader);
+    ShaderSource source = ShaderPreprocessor::Process(filePath);
+    m_Files = source.Files;
+    CreateShader(source.VertexSource, source.FragmentSource, feedbackVaryings);
+    Finalize();
+}
+
+Shader::Shader(const ShaderSource& source, const std::vector<std::string>& defines)
+	: m_RendererID(0)
+	, m_FilePath(source.Files.empty() ? std::string() : source.Files[0])
+	, m_Files(source.Files)
+	, m_VertexShader(0)
+	, m_FragmentShader(0)
+	, m_Finalized(false)
+	, m_Valid(false)
 {
-    ShaderProgramSource source = ParseShader(filePath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    MemoryTagScope tag(MemoryTag::Shader);
+    CreateShader(ShaderPreprocessor::InjectDefines(source.VertexSource, defines),
+        ShaderPreprocessor::InjectDefines(source.FragmentSource, defines));
 }
 
 Shader::~Shader()
 {
+    if (m_VertexShader)
+        glDeleteShader(m_VertexShader);
+    if (m_FragmentShader)
+        glDeleteShader(m_FragmentShader);
     glDeleteProgram(m_RendererID); // 清理着色器程序
 }
 
+bool Shader::EnableParallelCompile()
+{
+    // 0xFFFFFFFF 表示由驱动决定线程数
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if (GLEW_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    else
+        return false;
+
+    s_ParallelCompile = true;
+    return true;
+}
+
+bool Shader::IsParallelCompileEnabled()
+{
+    return s_ParallelCompile;
+}
+
 void Shader::Bind() const
 {
+    if (!m_Finalized)
+        Finalize();
     GLCALL(glUseProgram(m_RendererID));
 }
 
@@ -30,88 +94,127 @@ void Shader::UnBind() const
     GLCALL(glUseProgram(0));
 }
 
-void Shader::SetUniform1i(const std::string& name, int v1)
+void Shader::SetUniform1i(const char* name, int v1)
 {
     glUniform1i(GetUniformLocation(name), v1);
 }
 
-void Shader::SetUniform1f(const std::string& name, float v1)
+void Shader::SetUniform1f(const char* name, float v1)
 {
     glUniform1f(GetUniformLocation(name), v1);
 }
 
-void Shader::SetUniform4f(const std::string& name, float v1, float v2, float v3, float v4)
+void Shader::SetUniform2f(const char* name, float v1, float v2)
+{
+    glUniform2f(GetUniformLocation(name), v1, v2);
+}
+
+void Shader::SetUniform4f(const char* name, float v1, float v2, float v3, float v4)
 {
     glUniform4f(GetUniformLocation(name), v1, v2, v3, v4);
 }
 
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+void Shader::SetUniformMat4f(const char* name, const glm::mat4& matrix)
 {
     glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
 }
 
-int Shader::GetUniformLocation(const std::string& name) const
+int Shader::GetUniformLocation(const char* name) const
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-        return m_UniformLocationCache[name];
+    // FNV-1a
+    unsigned long long hash = 14695981039346656037ull;
+    for (const char* c = name; *c; c++)
+        hash = (hash ^ (unsigned char)*c) * 1099511628211ull;
+
+    for (const UniformLocation& uniform : m_UniformLocationCache)
+    {
+        if (uniform.Hash == hash)
+            return uniform.Location;
+    }
 
-    GLCALL(int location = glGetUniformLocation(m_RendererID, name.c_str()));
+    GLCALL(int location = glGetUniformLocation(m_RendererID, name));
     if (location == -1)
     {
         std::cout << "Warring:: uniform " << name << " doesn't exist!" << std::endl;
     }
-    m_UniformLocationCache[name] = location;
+    m_UniformLocationCache.push_back({ hash, location });
 	return location;
 }
 
-Shader::ShaderProgramSource Shader::ParseShader(const std::string& filePath)
+bool Shader::IsCompileComplete() const
 {
-    std::ifstream stream(filePath);
+    if (m_Finalized || !s_ParallelCompile)
+        return true;
 
-    enum class ShaderType
+    // GL_COMPLETION_STATUS_KHR 与 GL_COMPLETION_STATUS_ARB 的值相同
+    GLint complete = GL_FALSE;
+    glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+bool Shader::Finalize() const
+{
+    if (m_Finalized)
+        return m_Valid;
+    m_Finalized = true;
+
+    // 查询状态会等待驱动完成编译
+    bool compiled = CheckCompileStatus(m_VertexShader, GL_VERTEX_SHADER);
+    if (m_FragmentShader)
+        compiled &= CheckCompileStatus(m_FragmentShader, GL_FRAGMENT_SHADER);
+
+    int linked = GL_FALSE;
+    glGetProgramiv(m_RendererID, GL_LINK_STATUS, &linked);
+    if (compiled && linked == GL_FALSE)
     {
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
-    };
+        int length;
+        glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length);
+        char* errorLog = FrameArena::Get().Allocate<char>(length + 1);
+        errorLog[0] = 0;
+        glGetProgramInfoLog(m_RendererID, length + 1, &length, errorLog);
+        std::cout << "Failed to link shader " << m_FilePath << ": " << errorLog << std::endl;
+    }
+    else if (compiled)
+    {
+        GLCALL(glValidateProgram(m_RendererID)); // 验证有效性
+    }
 
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
-    while (getline(stream, line))
+    glDeleteShader(m_VertexShader);
+    m_VertexShader = 0;
+    if (m_FragmentShader)
     {
-        if (line.find("#shader") != std::string::npos)
-        {
-            if (line.find("vertex") != std::string::npos)
-            {
-                type = ShaderType::VERTEX;
-            }
-            else if (line.find("fragment") != std::string::npos)
-            {
-                type = ShaderType::FRAGMENT;
-            }
-        }
-        else
-        {
-            ss[(int)type] << line << "\n";
-        }
+        glDeleteShader(m_FragmentShader);
+        m_FragmentShader = 0;
     }
-    return { ss[0].str(), ss[1].str() };
+
+    m_Valid = compiled && linked == GL_TRUE;
+    return m_Valid;
 }
 
-unsigned int Shader::CreateShader(const std::string& VertexShader, const std::string& FragmentShader)
+void Shader::CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const std::vector<std::string>& feedbackVaryings)
 {
     unsigned int program = glCreateProgram();
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, VertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, FragmentShader);
+    m_VertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+    // 只做 transform feedback 的程序不需要片段着色器
+    m_FragmentShader = fragmentSource.empty() ? 0 : CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
 
-    GLCALL(glAttachShader(program, vs));
-    GLCALL(glAttachShader(program, fs));
-    GLCALL(glLinkProgram(program));
-    GLCALL(glValidateProgram(program)); // 验证有效性
+    GLCALL(glAttachShader(program, m_VertexShader));
+    if (m_FragmentShader)
+    {
+        GLCALL(glAttachShader(program, m_FragmentShader));
+    }
 
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    if (!feedbackVaryings.empty())
+    {
+        std::vector<const char*> varyings;
+        for (const std::string& varying : feedbackVaryings)
+            varyings.push_back(varying.c_str());
+        GLCALL(glTransformFeedbackVaryings(program, (GLsizei)varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS));
+    }
 
-    return program;
+    // 编译和链接都不查询结果，驱动支持并行编译时这里会立即返回
+    GLCALL(glLinkProgram(program));
+    m_RendererID = program;
 }
 
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
@@ -120,25 +223,31 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     const char* src = source.c_str();
     GLCALL(glShaderSource(id, 1, &src, nullptr));
     GLCALL(glCompileShader(id));
+    return id;
+}
 
-    // TODO:: Error Handling
+bool Shader::CheckCompileStatus(unsigned int id, unsigned int type) const
+{
     int res;
     glGetShaderiv(id, GL_COMPILE_STATUS, &res); // 获取着色器得编译结果
     if (res == GL_FALSE)
     {
         int length;
         glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length); // 获取着色器日志信息得长度
-        // char* errorLog = (char*)alloca(sizeof(char) * length); // 分配栈内存
-        std::vector<char> errorLog(length);
-        glGetShaderInfoLog(id, length, &length, &errorLog[0]); // 获取着色器日志信息
+        // 日志只在这里用一次，放在帧内存里
+        char* errorLog = FrameArena::Get().Allocate<char>(length + 1);
+        errorLog[0] = 0;
+        glGetShaderInfoLog(id, length + 1, &length, errorLog); // 获取着色器日志信息
+        // 日志中的 "0(12)" 为 源字符串编号(行号)，编号对应 #include 展开的文件
         std::cout << "Failed to compile "
             << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
             << " shader: "
-            << errorLog.data()
+            << errorLog
+            << "Source strings:\n"
+            << ShaderPreprocessor::DescribeFiles(m_Files)
             << std::endl;
-        glDeleteShader(id);
-        return 0;
+        return false;
     }
 
-    return id;
+    return true;
 }
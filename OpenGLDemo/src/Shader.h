@@ -1,40 +1,66 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
+struct ShaderSource;
+
 class Shader
 {
 public:
 	Shader(const std::string& filePath);
+	// 带 transform feedback 输出的程序，varyings 需要在链接前指定；文件可以只有顶点着色器
+	Shader(const std::string& filePath, const std::vector<std::string>& feedbackVaryings);
+	// 变体：在预处理结果中注入 defines 后编译。只提交编译和链接，不等待结果，
+	// 驱动支持并行编译时可以用 IsCompileComplete 轮询
+	Shader(const ShaderSource& source, const std::vector<std::string>& defines);
 	~Shader();
 
 	void Bind() const;
 	void UnBind() const;
 
-	// Set uniform
-	void SetUniform1i(const std::string& name, int v1);
-	void SetUniform1f(const std::string& name, float v1);
-	void SetUniform4f(const std::string& name, float v1, float v2, float v3, float v4);
+	// Set uniform（名字用 const char*，避免每次调用都构造 std::string）
+	void SetUniform1i(const char* name, int v1);
+	void SetUniform1f(const char* name, float v1);
+	void SetUniform2f(const char* name, float v1, float v2);
+	void SetUniform4f(const char* name, float v1, float v2, float v3, float v4);
 
-	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+	void SetUniformMat4f(const char* name, const glm::mat4& matrix);
 
-private:
-	int GetUniformLocation(const std::string& name) const;
+	// 不阻塞地查询编译和链接是否完成；不支持并行编译时总是返回 true
+	bool IsCompileComplete() const;
+	// 检查编译/链接结果并输出日志，会等待编译完成；Bind 时会自动调用
+	bool Finalize() const;
+	inline bool IsFinalized() const { return m_Finalized; }
+	inline bool IsValid() const { return m_Valid; }
 
-	struct ShaderProgramSource
-	{
-		std::string VertexSource;
-		std::string FragmentSource;
-	};
+	// 在 glewInit 之后调用一次：有 GL_KHR/ARB_parallel_shader_compile 时让驱动使用多线程编译
+	static bool EnableParallelCompile();
+	static bool IsParallelCompileEnabled();
+
+private:
+	int GetUniformLocation(const char* name) const;
 
-	ShaderProgramSource ParseShader(const std::string& filePath);
-	unsigned int CreateShader(const std::string& VertexShader, const std::string& FragmentShader);
+	void CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const std::vector<std::string>& feedbackVaryings = std::vector<std::string>());
 	unsigned int CompileShader(unsigned int type, const std::string& source);
+	bool CheckCompileStatus(unsigned int id, unsigned int type) const;
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
-	mutable std::unordered_map<std::string, int> m_UniformLocationCache;
-};
+	std::vector<std::string> m_Files;
+
+	// 编译完成前保留着色器对象，Finalize 时读取日志后删除
+	mutable unsigned int m_VertexShader;
+	mutable unsigned int m_FragmentShader;
+	mutable bool m_Finalized;
+	mutable bool m_Valid;
 
+	// 按名字的哈希缓存，一个着色器的 uniform 不多，线性查找比哈希表更快且不分配内存
+	struct UniformLocation
+	{
+		unsigned long long Hash;
+		int Location;
+	};
+	mutable std::vector<UniformLocation> m_UniformLocationCache;
+};
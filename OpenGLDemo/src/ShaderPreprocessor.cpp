@@ -0,0 +1,250 @@
+#include "ShaderPreprocessor.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+	enum class ShaderStage
+	{
+		None = -1, Vertex = 0, Fragment = 1
+	};
+
+	struct StageState
+	{
+		std::string* Output;
+		std::vector<std::string> Included;
+	};
+
+	bool ReadFile(const std::string& filePath, std::string& content)
+	{
+		std::ifstream stream(filePath, std::ios::binary);
+		if (!stream)
+			return false;
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		content = buffer.str();
+		return true;
+	}
+
+	std::string GetDirectory(const std::string& filePath)
+	{
+		size_t slash = filePath.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : filePath.substr(0, slash + 1);
+	}
+
+	// 去掉行首空白后是否以 directive 开头
+	bool StartsWithDirective(const std::string& line, const char* directive, size_t& after)
+	{
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos)
+			return false;
+		size_t length = strlen(directive);
+		if (line.compare(start, length, directive) != 0)
+			return false;
+		after = start + length;
+		return true;
+	}
+
+	bool ParseQuoted(const std::string& line, size_t from, std::string& value)
+	{
+		size_t open = line.find('"', from);
+		size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+		if (close == std::string::npos)
+			return false;
+		value = line.substr(open + 1, close - open - 1);
+		return true;
+	}
+
+	void AppendLineDirective(std::string& output, int line, int fileIndex)
+	{
+		output += "#line " + std::to_string(line) + " " + std::to_string(fileIndex) + "\n";
+	}
+
+	int AddFile(ShaderSource& source, const std::string& filePath)
+	{
+		for (size_t i = 0; i < source.Files.size(); i++)
+		{
+			if (source.Files[i] == filePath)
+				return (int)i;
+		}
+		source.Files.push_back(filePath);
+		return (int)source.Files.size() - 1;
+	}
+
+	bool ExpandInclude(const std::string& filePath, ShaderSource& source, StageState& stage, std::vector<std::string>& includeStack);
+
+	// 处理一行：#include 展开，#version 之后插入 #line 以便之后注入 #define 不影响行号
+	bool ProcessLine(const std::string& line, int lineNumber, int fileIndex, const std::string& directory,
+		ShaderSource& source, StageState& stage, std::vector<std::string>& includeStack)
+	{
+		size_t after;
+		if (StartsWithDirective(line, "#include", after))
+		{
+			std::string includePath;
+			if (!ParseQuoted(line, after, includePath))
+			{
+				std::cout << "Failed to parse include: " << source.Files[fileIndex] << "(" << lineNumber << "): " << line << std::endl;
+				return false;
+			}
+
+			// 先相对当前文件查找，再相对工作目录
+			std::string resolved = directory + includePath;
+			if (!std::ifstream(resolved).good())
+				resolved = includePath;
+			if (!ExpandInclude(resolved, source, stage, includeStack))
+				return false;
+			AppendLineDirective(*stage.Output, lineNumber + 1, fileIndex);
+			return true;
+		}
+
+		*stage.Output += line;
+		*stage.Output += "\n";
+		if (StartsWithDirective(line, "#version", after))
+			AppendLineDirective(*stage.Output, lineNumber + 1, fileIndex);
+		return true;
+	}
+
+	bool ExpandInclude(const std::string& filePath, ShaderSource& source, StageState& stage, std::vector<std::string>& includeStack)
+	{
+		for (const std::string& included : includeStack)
+		{
+			if (included == filePath)
+			{
+				std::cout << "Failed to include " << filePath << ": circular include" << std::endl;
+				return false;
+			}
+		}
+		for (const std::string& included : stage.Included)
+		{
+			if (included == filePath)
+				return true;
+		}
+
+		std::string content;
+		if (!ReadFile(filePath, content))
+		{
+			std::cout << "Failed to open shader include: " << filePath << std::endl;
+			return false;
+		}
+
+		stage.Included.push_back(filePath);
+		includeStack.push_back(filePath);
+		int fileIndex = AddFile(source, filePath);
+		std::string directory = GetDirectory(filePath);
+		AppendLineDirective(*stage.Output, 1, fileIndex);
+
+		std::istringstream stream(content);
+		std::string line;
+		int lineNumber = 0;
+		bool success = true;
+		while (success && std::getline(stream, line))
+		{
+			lineNumber++;
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			success = ProcessLine(line, lineNumber, fileIndex, directory, source, stage, includeStack);
+		}
+
+		includeStack.pop_back();
+		return success;
+	}
+
+}
+
+ShaderSource ShaderPreprocessor::Process(const std::string& filePath)
+{
+	ShaderSource source;
+	std::string content;
+	if (!ReadFile(filePath, content))
+	{
+		std::cout << "Failed to open shader: " << filePath << std::endl;
+		return source;
+	}
+
+	int fileIndex = AddFile(source, filePath);
+	std::string directory = GetDirectory(filePath);
+	StageState stages[2] = { { &source.VertexSource, {} }, { &source.FragmentSource, {} } };
+	ShaderStage type = ShaderStage::None;
+	std::vector<std::string> includeStack(1, filePath);
+
+	std::istringstream stream(content);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(stream, line))
+	{
+		lineNumber++;
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		size_t after;
+		if (StartsWithDirective(line, "#shader", after))
+		{
+			if (line.find("vertex", after) != std::string::npos)
+				type = ShaderStage::Vertex;
+			else if (line.find("fragment", after) != std::string::npos)
+				type = ShaderStage::Fragment;
+			continue;
+		}
+
+		if (StartsWithDirective(line, "#pragma permutation", after))
+		{
+			std::istringstream names(line.substr(after));
+			std::string name;
+			while (names >> name)
+			{
+				bool exists = false;
+				for (const std::string& permutation : source.Permutations)
+					exists |= permutation == name;
+				if (!exists)
+					source.Permutations.push_back(name);
+			}
+			continue;
+		}
+
+		// 第一个 #shader 之前的内容不属于任何阶段
+		if (type == ShaderStage::None)
+			continue;
+
+		if (!ProcessLine(line, lineNumber, fileIndex, directory, source, stages[(int)type], includeStack))
+			return source;
+	}
+
+	if (source.Permutations.size() > 32)
+	{
+		std::cout << "Failed to preprocess " << filePath << ": more than 32 permutations" << std::endl;
+		return source;
+	}
+
+	source.Valid = true;
+	return source;
+}
+
+std::string ShaderPreprocessor::InjectDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+	if (defines.empty())
+		return source;
+
+	std::string block;
+	for (const std::string& define : defines)
+		block += "#define " + define + "\n";
+
+	// #version 必须是第一条语句，#define 放在它的下一行
+	size_t version = source.find("#version");
+	if (version == std::string::npos)
+		return block + source;
+	size_t lineEnd = source.find('\n', version);
+	if (lineEnd == std::string::npos)
+		return source + "\n" + block;
+	return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+}
+
+std::string ShaderPreprocessor::DescribeFiles(const std::vector<std::string>& files)
+{
+	std::string description;
+	for (size_t i = 0; i < files.size(); i++)
+		description += "  " + std::to_string(i) + ": " + files[i] + "\n";
+	return description;
+}
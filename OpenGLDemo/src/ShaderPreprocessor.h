@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// 预处理后的着色器源码，各阶段已经展开了 #include
+struct ShaderSource
+{
+	std::string VertexSource;
+	std::string FragmentSource;
+	std::vector<std::string> Files;         // #line 中的源字符串编号 -> 文件路径
+	std::vector<std::string> Permutations;  // #pragma permutation 声明的开关，顺序即 key 中的位
+	bool Valid = false;
+};
+
+// 着色器文件格式：
+//   #shader vertex / #shader fragment   划分阶段
+//   #include "path"                     相对当前文件展开，同一阶段内每个文件只展开一次
+//   #pragma permutation NAME            声明一个变体开关，编译变体时以 #define NAME 注入
+class ShaderPreprocessor
+{
+public:
+	static ShaderSource Process(const std::string& filePath);
+
+	// 在 #version 之后插入 #define（"NAME" 或 "NAME VALUE"）
+	static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+	// 编译错误信息中的源字符串编号对应的文件
+	static std::string DescribeFiles(const std::vector<std::string>& files);
+};
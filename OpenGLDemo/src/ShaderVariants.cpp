@@ -0,0 +1,148 @@
+#include "ShaderVariants.h"
+
+#include "Shader.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+	double ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+}
+
+ShaderVariants::ShaderVariants(const std::string& filePath, unsigned int salt)
+	: m_FilePath(filePath)
+	, m_Salt(salt)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Source = ShaderPreprocessor::Process(filePath);
+	m_Stats.PreprocessMilliseconds = ElapsedMilliseconds(start);
+}
+
+ShaderVariants::~ShaderVariants()
+{
+}
+
+unsigned int ShaderVariants::GetKey(const char* permutation) const
+{
+	for (size_t i = 0; i < m_Source.Permutations.size(); i++)
+	{
+		if (m_Source.Permutations[i] == permutation)
+			return 1u << i;
+	}
+
+	std::cout << "Warring:: permutation " << permutation << " is not declared in " << m_FilePath << std::endl;
+	return 0;
+}
+
+unsigned int ShaderVariants::MaskKey(unsigned int key) const
+{
+	size_t count = m_Source.Permutations.size();
+	return count >= 32 ? key : key & ((1u << count) - 1);
+}
+
+void ShaderVariants::Request(unsigned int key)
+{
+	key = MaskKey(key);
+	if (!m_Source.Valid || m_Variants.find(key) != m_Variants.end())
+		return;
+
+	std::vector<std::string> defines;
+	for (size_t i = 0; i < m_Source.Permutations.size(); i++)
+	{
+		if (key & (1u << i))
+			defines.push_back(m_Source.Permutations[i]);
+	}
+	if (m_Salt)
+		defines.push_back("SHADER_CACHE_SALT " + std::to_string(m_Salt));
+
+	Variant& variant = m_Variants[key];
+	variant.SubmitTime = std::chrono::high_resolution_clock::now();
+	variant.Program = std::make_unique<Shader>(m_Source, defines);
+	variant.Pending = true;
+	m_Stats.SubmitMilliseconds += ElapsedMilliseconds(variant.SubmitTime);
+	m_Stats.Variants++;
+	m_Stats.Pending++;
+	m_PendingKeys.push_back(key);
+
+	// 没有并行编译时状态查询本来就会阻塞，直接完成
+	if (!Shader::IsParallelCompileEnabled())
+	{
+		Complete(variant);
+		m_PendingKeys.pop_back();
+	}
+}
+
+bool ShaderVariants::RequestAll()
+{
+	if (m_Source.Permutations.size() > MaxRequestAllPermutations)
+	{
+		std::cout << "Warring:: " << m_FilePath << " has " << m_Source.Permutations.size()
+			<< " permutations, too many to compile every combination" << std::endl;
+		return false;
+	}
+
+	unsigned int count = 1u << m_Source.Permutations.size();
+	for (unsigned int key = 0; key < count; key++)
+		Request(key);
+	return true;
+}
+
+void ShaderVariants::Poll()
+{
+	for (size_t i = 0; i < m_PendingKeys.size();)
+	{
+		Variant& variant = m_Variants[m_PendingKeys[i]];
+		if (!variant.Program->IsCompileComplete())
+		{
+			i++;
+			continue;
+		}
+
+		Complete(variant);
+		m_PendingKeys[i] = m_PendingKeys.back();
+		m_PendingKeys.pop_back();
+	}
+}
+
+Shader* ShaderVariants::Get(unsigned int key, bool wait)
+{
+	key = MaskKey(key);
+	auto it = m_Variants.find(key);
+	if (it == m_Variants.end())
+	{
+		Request(key);
+		it = m_Variants.find(key);
+		if (it == m_Variants.end())
+			return nullptr;
+	}
+
+	Variant& variant = it->second;
+	if (variant.Pending)
+	{
+		if (!wait && !variant.Program->IsCompileComplete())
+			return nullptr;
+		Complete(variant);
+		m_PendingKeys.erase(std::remove(m_PendingKeys.begin(), m_PendingKeys.end(), key), m_PendingKeys.end());
+	}
+	return variant.Program->IsValid() ? variant.Program.get() : nullptr;
+}
+
+void ShaderVariants::Complete(Variant& variant)
+{
+	if (!variant.Pending)
+		return;
+
+	if (!variant.Program->Finalize())
+		m_Stats.Failed++;
+
+	double latency = ElapsedMilliseconds(variant.SubmitTime);
+	m_Stats.TotalLatencyMilliseconds += latency;
+	m_Stats.MaxLatencyMilliseconds = std::max(m_Stats.MaxLatencyMilliseconds, latency);
+	m_Stats.Pending--;
+	variant.Pending = false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ShaderPreprocessor.h"
+
+class Shader;
+
+struct ShaderVariantStats
+{
+	unsigned int Variants = 0;
+	unsigned int Pending = 0;
+	unsigned int Failed = 0;
+	double PreprocessMilliseconds = 0.0;
+	double SubmitMilliseconds = 0.0;        // 主线程上花在 glCompileShader/glLinkProgram 调用里的时间
+	double TotalLatencyMilliseconds = 0.0;  // 从提交到检测到完成，检测精度取决于 Poll 的频率
+	double MaxLatencyMilliseconds = 0.0;
+
+	inline double GetAverageLatency() const
+	{
+		unsigned int completed = Variants - Pending;
+		return completed > 0 ? TotalLatencyMilliseconds / completed : 0.0;
+	}
+};
+
+// 一个着色器文件的所有变体：文件只预处理一次，变体由 #pragma permutation 开关的位组合（key）区分
+class ShaderVariants
+{
+public:
+	// salt 非 0 时作为额外的 #define 注入，改变源码以绕过驱动的着色器缓存（用于测量编译时间）
+	ShaderVariants(const std::string& filePath, unsigned int salt = 0);
+	~ShaderVariants();
+
+	// 开关对应的位，未声明的开关返回 0
+	unsigned int GetKey(const char* permutation) const;
+	inline unsigned int GetPermutationCount() const { return (unsigned int)m_Source.Permutations.size(); }
+	inline const std::string& GetPermutationName(unsigned int index) const { return m_Source.Permutations[index]; }
+
+	// 提交编译，已存在的变体直接返回
+	void Request(unsigned int key);
+	// 一次提交全部组合时允许的最大开关数（2^8 = 256 个程序）
+	static const unsigned int MaxRequestAllPermutations = 8;
+
+	// 提交所有 2^n 个组合，开关超过 MaxRequestAllPermutations 时拒绝并返回 false
+	bool RequestAll();
+	// 轮询还在编译的变体，每帧调用一次
+	void Poll();
+
+	// 绘制时调用：按 key 哈希查找。wait 为 false 时变体还在编译则返回 nullptr；第一次请求的变体会开始编译
+	Shader* Get(unsigned int key, bool wait = true);
+
+	inline bool IsValid() const { return m_Source.Valid; }
+	inline const ShaderVariantStats& GetStats() const { return m_Stats; }
+
+private:
+	struct Variant
+	{
+		std::unique_ptr<Shader> Program;
+		std::chrono::high_resolution_clock::time_point SubmitTime;
+		bool Pending;
+	};
+
+	void Complete(Variant& variant);
+	// 去掉未声明开关对应的位，否则宏完全相同的变体会被重复编译
+	unsigned int MaskKey(unsigned int key) const;
+
+private:
+	std::string m_FilePath;
+	unsigned int m_Salt;
+	ShaderSource m_Source;
+	std::unordered_map<unsigned int, Variant> m_Variants;
+	std::vector<unsigned int> m_PendingKeys;
+	ShaderVariantStats m_Stats;
+};
@@ -0,0 +1,228 @@
+#include "SpriteRenderer.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+
+namespace {
+
+	const float AlphaCutoff = 0.5f;
+	// 每次着色在加法混合下累加的颜色，叠加 10 层后接近白色
+	const glm::vec4 OverdrawColor(0.1f, 0.06f, 0.02f, 1.f);
+
+}
+
+SpriteRenderer::SpriteRenderer()
+	: m_AlphaTestKey(0)
+	, m_ViewProjection(1.f)
+	, m_SubmitCount(0)
+	, m_DepthSorting(true)
+	, m_OverdrawVisualization(false)
+	, m_QueryFrame(0)
+{
+	float vertexBuffer[] = {
+		-0.5f, -0.5f, 0.f, 0.f,
+		-0.5f,  0.5f, 0.f, 1.f,
+		 0.5f,  0.5f, 1.f, 1.f,
+		 0.5f, -0.5f, 1.f, 0.f,
+	};
+
+	unsigned int indices[] = {
+		0, 1, 2,
+		2, 3, 0,
+	};
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(vertexBuffer, sizeof(vertexBuffer));
+	VertexBufferLayout layout;
+	layout.Push<float>(2);
+	layout.Push<float>(2);
+	m_VAO->AddBuffer(*m_VBO, layout);
+	m_IBO = std::make_unique<IndexBuffer>(indices, sizeof(indices) / sizeof(unsigned int));
+
+	// 两个变体一起提交，支持并行编译时驱动可以同时编译
+	m_Shaders = std::make_unique<ShaderVariants>("res/shaders/Sprite.shader");
+	m_AlphaTestKey = m_Shaders->GetKey("ALPHA_TEST");
+	m_Shaders->Request(0);
+	m_Shaders->Request(m_AlphaTestKey);
+
+	glGenQueries(2, m_SampleQueries);
+}
+
+SpriteRenderer::~SpriteRenderer()
+{
+	glDeleteQueries(2, m_SampleQueries);
+}
+
+void SpriteRenderer::Begin(const glm::mat4& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	// 上一帧的队列可能来自另一块帧内存，重新创建并按上一帧的数量预留
+	unsigned int opaque = (unsigned int)m_OpaqueQueue.size();
+	unsigned int alphaTested = (unsigned int)m_AlphaTestedQueue.size();
+	unsigned int translucent = (unsigned int)m_TranslucentQueue.size();
+	m_OpaqueQueue = FrameVector<QueuedSprite>();
+	m_AlphaTestedQueue = FrameVector<QueuedSprite>();
+	m_TranslucentQueue = FrameVector<QueuedSprite>();
+	m_OpaqueQueue.reserve(opaque);
+	m_AlphaTestedQueue.reserve(alphaTested);
+	m_TranslucentQueue.reserve(translucent);
+	m_SubmitCount = 0;
+}
+
+void SpriteRenderer::Submit(const Sprite& sprite)
+{
+	glm::mat4 model = glm::translate(glm::mat4(1.f), sprite.Position);
+	model = glm::scale(model, glm::vec3(sprite.Size, 1.f));
+	QueuedSprite queued = { m_ViewProjection * model, sprite.SpriteTexture, sprite.Color, sprite.Position.z, m_SubmitCount++ };
+
+	SpriteBlendMode mode = sprite.Mode;
+	if (mode == SpriteBlendMode::Auto)
+	{
+		AlphaMode alphaMode = sprite.SpriteTexture ? sprite.SpriteTexture->GetAlphaMode() : AlphaMode::Opaque;
+		if (sprite.Color.a < 1.f || alphaMode == AlphaMode::Translucent)
+			mode = SpriteBlendMode::Translucent;
+		else if (alphaMode == AlphaMode::AlphaTested)
+			mode = SpriteBlendMode::AlphaTested;
+		else
+			mode = SpriteBlendMode::Opaque;
+	}
+
+	if (!m_DepthSorting)
+		m_TranslucentQueue.push_back(queued);
+	else if (mode == SpriteBlendMode::Opaque)
+		m_OpaqueQueue.push_back(queued);
+	else if (mode == SpriteBlendMode::AlphaTested)
+		m_AlphaTestedQueue.push_back(queued);
+	else
+		m_TranslucentQueue.push_back(queued);
+}
+
+void SpriteRenderer::End()
+{
+	m_Stats.OpaqueCount = (unsigned int)m_OpaqueQueue.size();
+	m_Stats.AlphaTestedCount = (unsigned int)m_AlphaTestedQueue.size();
+	m_Stats.TranslucentCount = (unsigned int)m_TranslucentQueue.size();
+	m_Stats.DrawCalls = 0;
+
+	// 读取上一帧的片段数
+	unsigned int previousQuery = m_SampleQueries[(m_QueryFrame + 1) % 2];
+	if (m_QueryFrame > 0)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(previousQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			GLuint64 samples = 0;
+			glGetQueryObjectui64v(previousQuery, GL_QUERY_RESULT, &samples);
+			m_Stats.SamplesPassed = samples;
+		}
+	}
+	glBeginQuery(GL_SAMPLES_PASSED, m_SampleQueries[m_QueryFrame % 2]);
+
+	if (m_OverdrawVisualization)
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE);
+	}
+
+	if (m_DepthSorting)
+	{
+		// 不用 stable_sort，它每次都会申请临时缓冲；用提交顺序作为第二关键字，
+		// 深度相同的精灵在 GL_LEQUAL 下后画的覆盖先画的，与提交顺序一致
+		auto frontToBack = [](const QueuedSprite& a, const QueuedSprite& b) {
+			return a.Depth > b.Depth || (a.Depth == b.Depth && a.Order < b.Order);
+		};
+		std::sort(m_OpaqueQueue.begin(), m_OpaqueQueue.end(), frontToBack);
+		std::sort(m_AlphaTestedQueue.begin(), m_AlphaTestedQueue.end(), frontToBack);
+		std::sort(m_TranslucentQueue.begin(), m_TranslucentQueue.end(), [](const QueuedSprite& a, const QueuedSprite& b) {
+			return a.Depth < b.Depth || (a.Depth == b.Depth && a.Order < b.Order);
+		});
+
+		// 不透明：从前往后，写深度，被挡住的片段在片段着色器之前就被剔除
+		glEnable(GL_DEPTH_TEST);
+		glDepthFunc(GL_LEQUAL);
+		glDepthMask(GL_TRUE);
+		if (!m_OverdrawVisualization)
+			glDisable(GL_BLEND);
+		DrawQueue(m_OpaqueQueue, m_Shaders->Get(0));
+
+		// alpha 测试：同样写深度，discard 会关闭 early-Z，所以放在不透明之后，尽量被已有深度挡住
+		Shader* alphaTestShader = m_Shaders->Get(m_AlphaTestKey);
+		if (alphaTestShader && !m_AlphaTestedQueue.empty())
+		{
+			alphaTestShader->Bind();
+			alphaTestShader->SetUniform1f("u_AlphaCutoff", AlphaCutoff);
+		}
+		DrawQueue(m_AlphaTestedQueue, alphaTestShader);
+
+		// 半透明：从后往前，只做深度测试不写深度
+		glDepthMask(GL_FALSE);
+	}
+	else
+	{
+		glDisable(GL_DEPTH_TEST);
+	}
+
+	if (!m_OverdrawVisualization)
+	{
+		// 线性透明度混合: FinalColor = SrcColor * SrcAlpha + DstColor * (1 - SrcAlpha)
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	DrawQueue(m_TranslucentQueue, m_Shaders->Get(0));
+
+	glEndQuery(GL_SAMPLES_PASSED);
+	m_QueryFrame++;
+
+	glDepthMask(GL_TRUE);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+}
+
+void SpriteRenderer::DrawQueue(const FrameVector<QueuedSprite>& queue, Shader* program)
+{
+	// 变体编译失败时 program 为 nullptr
+	if (queue.empty() || !program)
+		return;
+
+	Shader& shader = *program;
+
+	Renderer renderer;
+	shader.Bind();
+	shader.SetUniform1i("u_Texture", 0);
+	if (m_OverdrawVisualization)
+		shader.SetUniform4f("u_OverdrawColor", OverdrawColor.r, OverdrawColor.g, OverdrawColor.b, OverdrawColor.a);
+	else
+		shader.SetUniform4f("u_OverdrawColor", 0.f, 0.f, 0.f, 0.f);
+
+	const Texture* boundTexture = nullptr;
+	bool textureBound = false;
+	for (const QueuedSprite& sprite : queue)
+	{
+		if (!textureBound || sprite.SpriteTexture != boundTexture)
+		{
+			// 没有纹理的精灵解绑纹理单元 0，不沿用上一个精灵的纹理
+			if (sprite.SpriteTexture)
+			{
+				sprite.SpriteTexture->Bind(0);
+			}
+			else
+			{
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_2D, 0);
+			}
+			boundTexture = sprite.SpriteTexture;
+			textureBound = true;
+		}
+		shader.SetUniformMat4f("u_MVP", sprite.MVP);
+		shader.SetUniform4f("u_Color", sprite.Color.r, sprite.Color.g, sprite.Color.b, sprite.Color.a);
+		renderer.Draw(m_VAO.get(), m_IBO.get(), &shader);
+		m_Stats.DrawCalls++;
+	}
+}
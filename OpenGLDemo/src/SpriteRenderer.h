@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "glm/glm.hpp"
+#include "Texture.h"
+#include "FrameArena.h"
+
+class VertexArray;
+class VertexBuffer;
+class IndexBuffer;
+class Shader;
+class ShaderVariants;
+
+enum class SpriteBlendMode
+{
+	Auto,           // 根据纹理的 AlphaMode 和颜色的 alpha 自动分类
+	Opaque,
+	AlphaTested,
+	Translucent
+};
+
+struct Sprite
+{
+	glm::vec3 Position;     // z 为深度，范围与投影矩阵的 near/far 一致，越大越靠前
+	glm::vec2 Size;
+	const Texture* SpriteTexture;
+	glm::vec4 Color = glm::vec4(1.f);
+	SpriteBlendMode Mode = SpriteBlendMode::Auto;
+};
+
+struct SpriteRenderStats
+{
+	unsigned int OpaqueCount = 0;
+	unsigned int AlphaTestedCount = 0;
+	unsigned int TranslucentCount = 0;
+	unsigned int DrawCalls = 0;
+	// 通过深度测试的采样数（即实际着色的片段数），来自上一帧的 GL_SAMPLES_PASSED 查询
+	unsigned long long SamplesPassed = 0;
+};
+
+// 2D 精灵渲染：不透明/alpha 测试的精灵从前往后绘制并写深度，让 early-Z 剔除被遮挡的片段，
+// 只有半透明精灵从后往前排序并混合
+class SpriteRenderer
+{
+public:
+	SpriteRenderer();
+	~SpriteRenderer();
+
+	void Begin(const glm::mat4& viewProjection);
+	void Submit(const Sprite& sprite);
+	void End();
+
+	// 关闭时按提交顺序全部混合绘制，不使用深度缓冲（用于对比）
+	inline void SetDepthSorting(bool enable) { m_DepthSorting = enable; }
+	inline void SetOverdrawVisualization(bool enable) { m_OverdrawVisualization = enable; }
+	inline const SpriteRenderStats& GetStats() const { return m_Stats; }
+
+private:
+	struct QueuedSprite
+	{
+		glm::mat4 MVP;
+		const Texture* SpriteTexture;
+		glm::vec4 Color;
+		float Depth;
+		unsigned int Order;     // 提交顺序，深度相同时保持稳定
+	};
+
+	void DrawQueue(const FrameVector<QueuedSprite>& queue, Shader* program);
+
+private:
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+	// Sprite.shader 的两个变体：默认和 ALPHA_TEST
+	std::unique_ptr<ShaderVariants> m_Shaders;
+	unsigned int m_AlphaTestKey;
+
+	glm::mat4 m_ViewProjection;
+	// 队列只在 Begin 到 End 之间有效，放在帧内存中
+	FrameVector<QueuedSprite> m_OpaqueQueue;
+	FrameVector<QueuedSprite> m_AlphaTestedQueue;
+	FrameVector<QueuedSprite> m_TranslucentQueue;
+	unsigned int m_SubmitCount;
+
+	bool m_DepthSorting;
+	bool m_OverdrawVisualization;
+	SpriteRenderStats m_Stats;
+
+	// 两个查询交替使用，读取上一帧的结果避免等待 GPU
+	unsigned int m_SampleQueries[2];
+	unsigned int m_QueryFrame;
+};
@@ -0,0 +1,160 @@
+#include "TextRenderer.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Font.h"
+#include "GlyphAtlas.h"
+
+TextRenderer::TextRenderer()
+	: m_ViewProjection(1.f)
+	, m_Atlas(nullptr)
+{
+	// 每个字形 4 个顶点，16384 个字形正好用满 16 位索引
+	std::vector<unsigned short> indices(MaxGlyphsPerBatch * 6);
+	for (unsigned int i = 0; i < MaxGlyphsPerBatch; i++)
+	{
+		unsigned short base = (unsigned short)(i * 4);
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 3;
+		indices[i * 6 + 5] = base + 0;
+	}
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(MaxGlyphsPerBatch * 4 * (unsigned int)sizeof(TextVertex));
+	VertexBufferLayout layout;
+	layout.Push<float>(2);
+	layout.Push<float>(2);
+	layout.Push<char>(4);
+	m_VAO->AddBuffer(*m_VBO, layout);
+	m_IBO = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+	m_Shader = std::make_unique<Shader>("res/shaders/SDFText.shader");
+	m_Vertices.reserve(MaxGlyphsPerBatch * 4);
+}
+
+TextRenderer::~TextRenderer()
+{
+}
+
+void TextRenderer::Begin(const glm::mat4& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	m_Vertices.clear();
+	m_Atlas = nullptr;
+	m_Stats = TextRenderStats();
+}
+
+glm::vec2 TextRenderer::SubmitText(GlyphAtlas& atlas, const char* text, size_t length, const glm::vec2& position, float size, const glm::vec4& color)
+{
+	if (m_Atlas != &atlas)
+	{
+		Flush();
+		m_Atlas = &atlas;
+		m_Atlas->BeginBatch();
+	}
+
+	Font& font = atlas.GetFont();
+	unsigned char rgba[4] = {
+		(unsigned char)(glm::clamp(color.r, 0.f, 1.f) * 255.f + 0.5f),
+		(unsigned char)(glm::clamp(color.g, 0.f, 1.f) * 255.f + 0.5f),
+		(unsigned char)(glm::clamp(color.b, 0.f, 1.f) * 255.f + 0.5f),
+		(unsigned char)(glm::clamp(color.a, 0.f, 1.f) * 255.f + 0.5f),
+	};
+
+	float penX = position.x;
+	float penY = position.y;
+	float lineHeight = font.GetLineHeight() * size;
+	int previousGlyph = -1;
+
+	const char* it = text;
+	const char* end = text + length;
+	while (it < end)
+	{
+		unsigned int codepoint = Font::DecodeUTF8(it, end);
+		if (codepoint == '\n')
+		{
+			penX = position.x;
+			penY -= lineHeight;
+			previousGlyph = -1;
+			continue;
+		}
+
+		const GlyphMetrics& metrics = font.GetGlyph(codepoint);
+		if (previousGlyph >= 0)
+			penX += font.GetKerning(previousGlyph, metrics.GlyphIndex) * size;
+		previousGlyph = metrics.GlyphIndex;
+
+		const AtlasGlyph* glyph = atlas.GetGlyph(metrics.GlyphIndex);
+		if (!glyph)
+		{
+			// 图集里的字形都属于当前批次，先提交再回收
+			Flush();
+			m_Atlas->BeginBatch();
+			m_Stats.EvictionFlushes++;
+			glyph = atlas.GetGlyph(metrics.GlyphIndex);
+		}
+
+		if (glyph && !glyph->Empty)
+		{
+			if (m_Vertices.size() >= MaxGlyphsPerBatch * 4)
+				Flush();
+
+			// 图集中 y 向下，世界坐标 y 向上
+			float x0 = penX + glyph->OffsetX * size;
+			float x1 = x0 + glyph->Width * size;
+			float y0 = penY - glyph->OffsetY * size;
+			float y1 = y0 - glyph->Height * size;
+
+			TextVertex quad[4] = {
+				{ { x0, y1 }, { glyph->U0, glyph->V1 }, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+				{ { x0, y0 }, { glyph->U0, glyph->V0 }, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+				{ { x1, y0 }, { glyph->U1, glyph->V0 }, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+				{ { x1, y1 }, { glyph->U1, glyph->V1 }, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+			};
+			m_Vertices.insert(m_Vertices.end(), quad, quad + 4);
+			m_Stats.Glyphs++;
+		}
+
+		penX += metrics.Advance * size;
+	}
+
+	return glm::vec2(penX, penY);
+}
+
+void TextRenderer::End()
+{
+	Flush();
+	m_Atlas = nullptr;
+}
+
+void TextRenderer::Flush()
+{
+	if (m_Vertices.empty() || !m_Atlas)
+		return;
+
+	m_VBO->SetData(m_Vertices.data(), (unsigned int)(m_Vertices.size() * sizeof(TextVertex)));
+
+	// 文字总是半透明的，不写深度
+	GLCALL(glEnable(GL_BLEND));
+	GLCALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+	m_Atlas->Bind(0);
+	m_Shader->Bind();
+	m_Shader->SetUniformMat4f("u_MVP", m_ViewProjection);
+	m_Shader->SetUniform1i("u_Texture", 0);
+
+	m_VAO->Bind();
+	m_IBO->Bind();
+	unsigned int indexCount = (unsigned int)(m_Vertices.size() / 4 * 6);
+	GLCALL(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, nullptr));
+	m_Stats.DrawCalls++;
+
+	GLCALL(glDisable(GL_BLEND));
+	m_Vertices.clear();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "glm/glm.hpp"
+
+class VertexArray;
+class VertexBuffer;
+class IndexBuffer;
+class Shader;
+class GlyphAtlas;
+
+struct TextVertex
+{
+	float Position[2];
+	float TexCoord[2];
+	unsigned char Color[4];
+};
+
+struct TextRenderStats
+{
+	unsigned int Glyphs = 0;
+	unsigned int DrawCalls = 0;
+	unsigned int EvictionFlushes = 0;   // 图集满了不得不提前提交的次数
+};
+
+// 批量文字渲染：排版结果写入同一个动态顶点缓冲，只有缓冲写满、切换图集或图集需要回收时才提交
+class TextRenderer
+{
+public:
+	static const unsigned int MaxGlyphsPerBatch = 16384;
+
+	TextRenderer();
+	~TextRenderer();
+
+	void Begin(const glm::mat4& viewProjection);
+	// position 为第一行基线的起点，size 为字号（世界单位下的像素高度），支持 '\n' 换行；返回结束时的笔位置
+	glm::vec2 SubmitText(GlyphAtlas& atlas, const char* text, size_t length, const glm::vec2& position, float size, const glm::vec4& color);
+
+	// 字符串字面量直接传入，不构造临时的 std::string
+	inline glm::vec2 SubmitText(GlyphAtlas& atlas, const char* text, const glm::vec2& position, float size, const glm::vec4& color)
+	{
+		return SubmitText(atlas, text, strlen(text), position, size, color);
+	}
+
+	inline glm::vec2 SubmitText(GlyphAtlas& atlas, const std::string& text, const glm::vec2& position, float size, const glm::vec4& color)
+	{
+		return SubmitText(atlas, text.data(), text.size(), position, size, color);
+	}
+	void End();
+
+	inline const TextRenderStats& GetStats() const { return m_Stats; }
+
+private:
+	void Flush();
+
+private:
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+	std::unique_ptr<Shader> m_Shader;
+
+	glm::mat4 m_ViewProjection;
+	std::vector<TextVertex> m_Vertices;
+	GlyphAtlas* m_Atlas;
+	TextRenderStats m_Stats;
+};
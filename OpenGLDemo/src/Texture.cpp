@@ -9,6 +9,7 @@ Texture::Texture(const std::string& filePath)
 	, m_Width(0)
 	, m_Height(0)
 	, m_BPP(0)
+	, m_AlphaMode(AlphaMode::Opaque)
 {
 	stbi_set_flip_vertically_on_load(1);
 	m_LocalBuffer = stbi_load(filePath.c_str(), &m_Width, &m_Height, &m_BPP, 4);
@@ -26,10 +27,44 @@ Texture::Texture(const std::string& filePath)
 
 	if (m_LocalBuffer)
 	{
+		// 原图有 alpha 通道时统计 alpha 分布，接近 0/255 的值视为不透明或全透明
+		if (m_BPP == 4)
+		{
+			for (int i = 0; i < m_Width * m_Height; i++)
+			{
+				unsigned char alpha = m_LocalBuffer[i * 4 + 3];
+				if (alpha > 5 && alpha < 250)
+				{
+					m_AlphaMode = AlphaMode::Translucent;
+					break;
+				}
+				if (alpha <= 5)
+					m_AlphaMode = AlphaMode::AlphaTested;
+			}
+		}
 		stbi_image_free(m_LocalBuffer);
 	}
 }
 
+Texture::Texture(int width, int height, const unsigned char* pixels)
+	: m_RendererID(0)
+	, m_LocalBuffer(nullptr)
+	, m_Width(width)
+	, m_Height(height)
+	, m_BPP(4)
+	, m_AlphaMode(AlphaMode::Opaque)
+{
+	glGenTextures(1, &m_RendererID);
+	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+}
+
 Texture::~Texture()
 {
 	glDeleteTextures(1, &m_RendererID);
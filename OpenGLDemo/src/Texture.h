@@ -2,6 +2,14 @@
 
 #include <string>
 
+// 根据像素的 alpha 通道对纹理分类，决定精灵走哪个渲染队列
+enum class AlphaMode
+{
+	Opaque,         // alpha 全部为 1
+	AlphaTested,    // alpha 只有 0 或 1，可以用 discard 代替混合
+	Translucent     // 存在半透明像素，必须排序后混合
+};
+
 class Texture
 {
 private:
@@ -9,8 +17,11 @@ private:
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	AlphaMode m_AlphaMode;
 public:
 	Texture(const std::string& filePath);
+	// 程序生成的 RGBA8 纹理（如瓦片图集），使用最近点采样，不检查 alpha
+	Texture(int width, int height, const unsigned char* pixels);
 	~Texture();
 
 	void Bind(unsigned int slot = 0) const;
@@ -18,5 +29,6 @@ public:
 
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline AlphaMode GetAlphaMode() const { return m_AlphaMode; }
 };
 
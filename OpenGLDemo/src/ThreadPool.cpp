@@ -0,0 +1,97 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: m_Job(nullptr)
+	, m_JobContext(nullptr)
+	, m_Count(0)
+	, m_Granularity(1)
+	, m_ChunkCount(0)
+	, m_NextChunk(0)
+	, m_Generation(0)
+	, m_ActiveWorkers(0)
+	, m_Quit(false)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_WorkCondition.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+void ThreadPool::Dispatch(unsigned int count, unsigned int granularity, JobFunction job, const void* context)
+{
+	granularity = std::max(1u, granularity);
+	unsigned int chunkCount = (count + granularity - 1) / granularity;
+	if (chunkCount <= 1 || m_Workers.empty())
+	{
+		if (count > 0)
+			job(context, 0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Job = job;
+		m_JobContext = context;
+		m_Count = count;
+		m_Granularity = granularity;
+		m_ChunkCount = chunkCount;
+		m_NextChunk = 0;
+		m_ActiveWorkers = (unsigned int)m_Workers.size();
+		m_Generation++;
+	}
+	m_WorkCondition.notify_all();
+
+	RunChunks();
+
+	// job 是调用方栈上的对象，必须等所有工作线程退出 RunChunks 才能返回
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_DoneCondition.wait(lock, [this]() { return m_ActiveWorkers == 0; });
+	m_Job = nullptr;
+	m_JobContext = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned int generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkCondition.wait(lock, [this, generation]() { return m_Quit || m_Generation != generation; });
+			if (m_Quit)
+				return;
+			generation = m_Generation;
+		}
+
+		RunChunks();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (--m_ActiveWorkers == 0)
+			m_DoneCondition.notify_one();
+	}
+}
+
+void ThreadPool::RunChunks()
+{
+	unsigned int chunk;
+	while ((chunk = m_NextChunk++) < m_ChunkCount)
+	{
+		unsigned int begin = chunk * m_Granularity;
+		unsigned int end = std::min(m_Count, begin + m_Granularity);
+		m_Job(m_JobContext, begin, end);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻工作线程，用于每帧都要执行的并行循环，避免每帧创建线程的开销
+class ThreadPool
+{
+public:
+	// threadCount 为 0 时使用 hardware_concurrency - 1 个工作线程，调用线程也参与计算
+	ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// 把 [0, count) 按 granularity 切块并行执行 job(begin, end)，所有块完成后返回。
+	// 只保存 job 的地址，不像 std::function 那样可能为捕获的变量分配内存
+	template<typename Function>
+	void ParallelFor(unsigned int count, unsigned int granularity, const Function& job)
+	{
+		Dispatch(count, granularity, &InvokeJob<Function>, &job);
+	}
+
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size() + 1; }
+
+private:
+	typedef void(*JobFunction)(const void* context, unsigned int begin, unsigned int end);
+
+	template<typename Function>
+	static void InvokeJob(const void* context, unsigned int begin, unsigned int end)
+	{
+		(*(const Function*)context)(begin, end);
+	}
+
+	void Dispatch(unsigned int count, unsigned int granularity, JobFunction job, const void* context);
+	void WorkerLoop();
+	void RunChunks();
+
+private:
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkCondition;
+	std::condition_variable m_DoneCondition;
+
+	JobFunction m_Job;
+	const void* m_JobContext;
+	unsigned int m_Count;
+	unsigned int m_Granularity;
+	unsigned int m_ChunkCount;
+	std::atomic<unsigned int> m_NextChunk;
+	unsigned int m_Generation;
+	unsigned int m_ActiveWorkers;
+	bool m_Quit;
+};
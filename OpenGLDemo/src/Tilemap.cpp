@@ -0,0 +1,323 @@
+#include "Tilemap.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+	double ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	unsigned short ToUnorm16(float value)
+	{
+		return (unsigned short)std::lround(std::min(std::max(value, 0.f), 1.f) * 65535.f);
+	}
+
+}
+
+Tilemap::Tilemap(int width, int height, const Texture* atlas, int atlasColumns, int atlasRows, unsigned int maxResidentChunks)
+	: m_Width(std::min(std::max(width, 1), 65535))
+	, m_Height(std::min(std::max(height, 1), 65535))
+	, m_Atlas(atlas)
+	, m_AtlasColumns(atlasColumns)
+	, m_AtlasRows(atlasRows)
+	, m_MaxResidentChunks(maxResidentChunks)
+	, m_Frame(0)
+	, m_MaxBuildsPerFrame(256)
+	, m_MultiDraw(false)
+	, m_ThreadedBuild(true)
+	, m_PendingEdits(0)
+{
+	// 顶点坐标用 unsigned short 保存
+	if (width != m_Width || height != m_Height)
+		std::cout << "Warring:: tilemap size " << width << "x" << height << " is clamped to " << m_Width << "x" << m_Height << std::endl;
+
+	m_ChunksX = (m_Width + ChunkSize - 1) / ChunkSize;
+	m_ChunksY = (m_Height + ChunkSize - 1) / ChunkSize;
+	m_Tiles.assign((size_t)m_Width * m_Height, 0);
+	m_Chunks.resize((size_t)m_ChunksX * m_ChunksY);
+
+	int tileCount = m_AtlasColumns * m_AtlasRows;
+	float atlasWidth = (float)std::max(m_Atlas->GetWidth(), 1);
+	float atlasHeight = (float)std::max(m_Atlas->GetHeight(), 1);
+	float cellWidth = atlasWidth / m_AtlasColumns;
+	float cellHeight = atlasHeight / m_AtlasRows;
+	m_TileUVs.resize((size_t)(tileCount + 1) * 4, 0);
+	for (int tile = 1; tile <= tileCount; tile++)
+	{
+		int column = (tile - 1) % m_AtlasColumns;
+		int row = (tile - 1) / m_AtlasColumns;
+		unsigned short* uv = &m_TileUVs[(size_t)tile * 4];
+		uv[0] = ToUnorm16((column * cellWidth + 0.5f) / atlasWidth);
+		uv[1] = ToUnorm16((row * cellHeight + 0.5f) / atlasHeight);
+		uv[2] = ToUnorm16(((column + 1) * cellWidth - 0.5f) / atlasWidth);
+		uv[3] = ToUnorm16(((row + 1) * cellHeight - 0.5f) / atlasHeight);
+	}
+
+	// 所有区块共用的四边形索引，配合 base vertex 指向各自的槽位
+	std::vector<unsigned short> indices(ChunkSize * ChunkSize * 6);
+	for (unsigned int quad = 0; quad < ChunkSize * ChunkSize; quad++)
+	{
+		unsigned short vertex = (unsigned short)(quad * 4);
+		unsigned short* index = &indices[quad * 6];
+		index[0] = vertex;
+		index[1] = vertex + 1;
+		index[2] = vertex + 2;
+		index[3] = vertex + 2;
+		index[4] = vertex + 3;
+		index[5] = vertex;
+	}
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(m_MaxResidentChunks * VerticesPerChunk * (unsigned int)sizeof(TileVertex));
+	VertexBufferLayout layout;
+	layout.Push(VertexBufferElement(GL_UNSIGNED_SHORT, 2, GL_FALSE));
+	layout.Push(VertexBufferElement(GL_UNSIGNED_SHORT, 2, GL_TRUE));
+	m_VAO->AddBuffer(*m_VBO, layout);
+	m_IBO = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+	m_Shader = std::make_unique<Shader>("res/shaders/Tilemap.shader");
+	m_ThreadPool = std::make_unique<ThreadPool>();
+
+	m_SlotOwner.assign(m_MaxResidentChunks, -1);
+	m_FreeSlots.reserve(m_MaxResidentChunks);
+	for (int slot = (int)m_MaxResidentChunks - 1; slot >= 0; slot--)
+		m_FreeSlots.push_back(slot);
+}
+
+Tilemap::~Tilemap()
+{
+}
+
+void Tilemap::SetTile(int x, int y, unsigned short tile)
+{
+	if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+		return;
+
+	unsigned short& current = m_Tiles[(size_t)y * m_Width + x];
+	if (current == tile)
+		return;
+
+	current = tile;
+	m_PendingEdits++;
+	// 还没构建的区块在进入视野时会按最新的瓦片构建
+	Chunk& chunk = m_Chunks[(size_t)(y / ChunkSize) * m_ChunksX + x / ChunkSize];
+	if (chunk.Built)
+		chunk.Dirty = true;
+}
+
+unsigned int Tilemap::BuildChunk(unsigned int chunk, TileVertex* vertices) const
+{
+	int x0 = (int)(chunk % m_ChunksX) * ChunkSize;
+	int y0 = (int)(chunk / m_ChunksX) * ChunkSize;
+	int x1 = std::min(x0 + ChunkSize, m_Width);
+	int y1 = std::min(y0 + ChunkSize, m_Height);
+	unsigned short tileCount = (unsigned short)(m_AtlasColumns * m_AtlasRows);
+
+	unsigned int quads = 0;
+	for (int y = y0; y < y1; y++)
+	{
+		const unsigned short* row = &m_Tiles[(size_t)y * m_Width];
+		for (int x = x0; x < x1; x++)
+		{
+			unsigned short tile = row[x];
+			if (tile == 0 || tile > tileCount)
+				continue;
+
+			const unsigned short* uv = &m_TileUVs[(size_t)tile * 4];
+			unsigned short px = (unsigned short)x, py = (unsigned short)y;
+			TileVertex* quad = vertices + quads * 4;
+			quad[0] = { px,                         py,                         uv[0], uv[1] };
+			quad[1] = { (unsigned short)(px + 1),   py,                         uv[2], uv[1] };
+			quad[2] = { (unsigned short)(px + 1),   (unsigned short)(py + 1),   uv[2], uv[3] };
+			quad[3] = { px,                         (unsigned short)(py + 1),   uv[0], uv[3] };
+			quads++;
+		}
+	}
+	return quads;
+}
+
+bool Tilemap::AcquireSlot(unsigned int chunk)
+{
+	if (m_FreeSlots.empty())
+	{
+		// 每帧第一次槽位不够时收集不可见的区块，按最后可见的帧排序，最久没看到的在末尾
+		if (m_EvictCandidates.empty())
+		{
+			for (unsigned int slot = 0; slot < m_MaxResidentChunks; slot++)
+			{
+				int owner = m_SlotOwner[slot];
+				if (owner >= 0 && m_Chunks[owner].LastVisibleFrame != m_Frame)
+					m_EvictCandidates.push_back((int)slot);
+			}
+			std::sort(m_EvictCandidates.begin(), m_EvictCandidates.end(), [this](int a, int b)
+			{
+				return m_Chunks[m_SlotOwner[a]].LastVisibleFrame > m_Chunks[m_SlotOwner[b]].LastVisibleFrame;
+			});
+		}
+		if (m_EvictCandidates.empty())
+			return false;
+
+		int slot = m_EvictCandidates.back();
+		m_EvictCandidates.pop_back();
+		ReleaseSlot((unsigned int)m_SlotOwner[slot]);
+	}
+
+	int slot = m_FreeSlots.back();
+	m_FreeSlots.pop_back();
+	m_SlotOwner[slot] = (int)chunk;
+	m_Chunks[chunk].Slot = slot;
+	return true;
+}
+
+void Tilemap::ReleaseSlot(unsigned int chunk)
+{
+	Chunk& owner = m_Chunks[chunk];
+	if (owner.Slot < 0)
+		return;
+
+	m_SlotOwner[owner.Slot] = -1;
+	m_FreeSlots.push_back(owner.Slot);
+	owner.Slot = -1;
+	owner.Built = false;
+	owner.Dirty = false;
+	owner.QuadCount = 0;
+}
+
+void Tilemap::Render(const glm::mat4& viewProjection, const glm::vec2& viewMin, const glm::vec2& viewMax)
+{
+	m_Frame++;
+	m_Stats = TilemapStats();
+	m_Stats.Edits = m_PendingEdits;
+	m_PendingEdits = 0;
+
+	// 视锥剔除：相机范围对应的区块区间
+	auto start = std::chrono::high_resolution_clock::now();
+	int cx0 = std::max((int)std::floor(viewMin.x / ChunkSize), 0);
+	int cy0 = std::max((int)std::floor(viewMin.y / ChunkSize), 0);
+	int cx1 = std::min((int)std::floor(viewMax.x / ChunkSize), m_ChunksX - 1);
+	int cy1 = std::min((int)std::floor(viewMax.y / ChunkSize), m_ChunksY - 1);
+
+	m_Visible.clear();
+	m_BuildList.clear();
+	m_EvictCandidates.clear();
+	for (int cy = cy0; cy <= cy1; cy++)
+	{
+		for (int cx = cx0; cx <= cx1; cx++)
+		{
+			unsigned int index = (unsigned int)(cy * m_ChunksX + cx);
+			m_Chunks[index].LastVisibleFrame = m_Frame;
+			m_Visible.push_back(index);
+		}
+	}
+	m_Stats.VisibleChunks = (unsigned int)m_Visible.size();
+	m_Stats.CullMilliseconds = ElapsedMilliseconds(start);
+
+	// 需要构建的区块：可见且从未构建、已被回收或被修改过
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int index : m_Visible)
+	{
+		Chunk& chunk = m_Chunks[index];
+		if (chunk.Built && !chunk.Dirty)
+			continue;
+		if (m_BuildList.size() >= m_MaxBuildsPerFrame)
+			break;
+		if (chunk.Slot < 0 && !AcquireSlot(index))
+			break;
+
+		if (chunk.Built)
+			m_Stats.ChunksRebuilt++;
+		else
+			m_Stats.ChunksStreamed++;
+		m_BuildList.push_back(index);
+	}
+
+	unsigned int buildCount = (unsigned int)m_BuildList.size();
+	if (m_Staging.size() < (size_t)buildCount * VerticesPerChunk)
+		m_Staging.resize((size_t)buildCount * VerticesPerChunk);
+	m_BuildQuads.resize(buildCount);
+
+	if (m_ThreadedBuild && buildCount > 1)
+	{
+		m_ThreadPool->ParallelFor(buildCount, 1, [this](unsigned int begin, unsigned int end) {
+			for (unsigned int i = begin; i < end; i++)
+				m_BuildQuads[i] = BuildChunk(m_BuildList[i], &m_Staging[(size_t)i * VerticesPerChunk]);
+		});
+	}
+	else
+	{
+		for (unsigned int i = 0; i < buildCount; i++)
+			m_BuildQuads[i] = BuildChunk(m_BuildList[i], &m_Staging[(size_t)i * VerticesPerChunk]);
+	}
+	m_Stats.BuildMilliseconds = ElapsedMilliseconds(start);
+
+	// 上传到各自的槽位，空区块直接释放槽位
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < buildCount; i++)
+	{
+		unsigned int index = m_BuildList[i];
+		unsigned int quads = m_BuildQuads[i];
+		if (quads == 0)
+			ReleaseSlot(index);
+		else
+			m_VBO->SetSubData(&m_Staging[(size_t)i * VerticesPerChunk], quads * 4 * (unsigned int)sizeof(TileVertex), (unsigned int)m_Chunks[index].Slot * VerticesPerChunk * (unsigned int)sizeof(TileVertex));
+
+		Chunk& chunk = m_Chunks[index];
+		chunk.QuadCount = quads;
+		chunk.Built = true;
+		chunk.Dirty = false;
+	}
+	m_Stats.UploadMilliseconds = ElapsedMilliseconds(start);
+
+	// 绘制
+	m_Shader->Bind();
+	m_Shader->SetUniformMat4f("u_MVP", viewProjection);
+	m_Shader->SetUniform1i("u_Texture", 0);
+	m_Atlas->Bind(0);
+	m_VAO->Bind();
+	m_IBO->Bind();
+
+	m_DrawCounts.clear();
+	m_DrawOffsets.clear();
+	m_DrawBaseVertices.clear();
+	for (unsigned int index : m_Visible)
+	{
+		const Chunk& chunk = m_Chunks[index];
+		if (!chunk.Built || chunk.Dirty)
+			m_Stats.PendingChunks++;
+		if (!chunk.Built || chunk.QuadCount == 0)
+			continue;
+
+		int count = (int)chunk.QuadCount * 6;
+		int baseVertex = chunk.Slot * (int)VerticesPerChunk;
+		m_Stats.QuadsDrawn += chunk.QuadCount;
+		if (m_MultiDraw)
+		{
+			m_DrawCounts.push_back(count);
+			m_DrawOffsets.push_back(nullptr);
+			m_DrawBaseVertices.push_back(baseVertex);
+		}
+		else
+		{
+			GLCALL(glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, nullptr, baseVertex));
+			m_Stats.DrawCalls++;
+		}
+	}
+	if (m_MultiDraw && !m_DrawCounts.empty())
+	{
+		GLCALL(glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_DrawCounts.data(), GL_UNSIGNED_SHORT, m_DrawOffsets.data(), (GLsizei)m_DrawCounts.size(), m_DrawBaseVertices.data()));
+		m_Stats.DrawCalls++;
+	}
+
+	m_Stats.ResidentChunks = m_MaxResidentChunks - (unsigned int)m_FreeSlots.size();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "glm/glm.hpp"
+
+class Texture;
+class Shader;
+class VertexArray;
+class VertexBuffer;
+class IndexBuffer;
+class ThreadPool;
+
+struct TilemapStats
+{
+	unsigned int VisibleChunks = 0;
+	unsigned int ResidentChunks = 0;    // 占用顶点缓冲槽位的区块
+	unsigned int PendingChunks = 0;     // 可见但本帧超出构建预算或槽位不足，还没有画出来
+	unsigned int DrawCalls = 0;
+	unsigned int QuadsDrawn = 0;        // 也是逐瓦片调用 Renderer::Draw 时的绘制次数
+	unsigned int Edits = 0;             // 本帧 SetTile 修改的瓦片数
+	unsigned int ChunksRebuilt = 0;     // 因为修改而重建
+	unsigned int ChunksStreamed = 0;    // 因为进入视野而构建
+	double BuildMilliseconds = 0.0;     // 生成顶点（可多线程）
+	double UploadMilliseconds = 0.0;
+	double CullMilliseconds = 0.0;
+};
+
+// 分区块的瓦片地图：每 ChunkSize x ChunkSize 个瓦片烘焙成一段静态顶点数据，放在一个大顶点缓冲的固定槽位中，
+// 所有区块共用一个 16 位索引缓冲（glDrawElementsBaseVertex）。只有被修改过或新进入视野的区块才重新生成，
+// 槽位不够时回收最久没有被看到的区块
+class Tilemap
+{
+public:
+	static const int ChunkSize = 32;
+	static const unsigned int VerticesPerChunk = ChunkSize * ChunkSize * 4;
+
+	// 瓦片编号 0 为空，1..atlasColumns*atlasRows 对应图集中从左下开始的格子
+	Tilemap(int width, int height, const Texture* atlas, int atlasColumns, int atlasRows, unsigned int maxResidentChunks = 2048);
+	~Tilemap();
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline unsigned short GetTile(int x, int y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+	void SetTile(int x, int y, unsigned short tile);
+
+	// viewMin/viewMax 为相机可见范围（瓦片坐标），一个瓦片占 1x1 的世界单位
+	void Render(const glm::mat4& viewProjection, const glm::vec2& viewMin, const glm::vec2& viewMax);
+
+	// 每帧最多构建的区块数，避免镜头快速移动时一帧内烘焙太多
+	inline void SetMaxBuildsPerFrame(unsigned int count) { m_MaxBuildsPerFrame = count; }
+	// 所有可见区块合并为一次 glMultiDrawElementsBaseVertex
+	inline void SetMultiDraw(bool enabled) { m_MultiDraw = enabled; }
+	inline void SetThreadedBuild(bool enabled) { m_ThreadedBuild = enabled; }
+
+	inline unsigned int GetChunkCount() const { return (unsigned int)m_Chunks.size(); }
+	inline unsigned int GetMaxResidentChunks() const { return m_MaxResidentChunks; }
+	inline const TilemapStats& GetStats() const { return m_Stats; }
+
+private:
+	struct TileVertex
+	{
+		unsigned short X, Y;    // 瓦片坐标
+		unsigned short U, V;    // 归一化的图集坐标
+	};
+
+	struct Chunk
+	{
+		int Slot = -1;
+		unsigned int QuadCount = 0;
+		unsigned int LastVisibleFrame = 0;
+		bool Built = false;     // 顶点数据与瓦片一致（为空的区块不占槽位）
+		bool Dirty = false;     // 构建后又被修改过
+	};
+
+	// 把区块的瓦片写成顶点，返回四边形数量
+	unsigned int BuildChunk(unsigned int chunk, TileVertex* vertices) const;
+	bool AcquireSlot(unsigned int chunk);
+	void ReleaseSlot(unsigned int chunk);
+
+private:
+	int m_Width, m_Height;
+	int m_ChunksX, m_ChunksY;
+	std::vector<unsigned short> m_Tiles;
+	std::vector<Chunk> m_Chunks;
+
+	const Texture* m_Atlas;
+	int m_AtlasColumns, m_AtlasRows;
+	// 每个图集格子四个角的 UV，向内收缩半个像素避免采样到相邻格子
+	std::vector<unsigned short> m_TileUVs;
+
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+	std::unique_ptr<Shader> m_Shader;
+	std::unique_ptr<ThreadPool> m_ThreadPool;
+
+	unsigned int m_MaxResidentChunks;
+	std::vector<int> m_SlotOwner;
+	std::vector<int> m_FreeSlots;
+
+	// 每帧复用的临时数组
+	std::vector<unsigned int> m_Visible;
+	std::vector<unsigned int> m_BuildList;
+	std::vector<unsigned int> m_BuildQuads;
+	std::vector<TileVertex> m_Staging;
+	std::vector<int> m_EvictCandidates;
+	std::vector<int> m_DrawCounts;
+	std::vector<void*> m_DrawOffsets;
+	std::vector<int> m_DrawBaseVertices;
+
+	unsigned int m_Frame;
+	unsigned int m_MaxBuildsPerFrame;
+	bool m_MultiDraw;
+	bool m_ThreadedBuild;
+	unsigned int m_PendingEdits;
+	TilemapStats m_Stats;
+};
@@ -3,12 +3,21 @@
 #include "Renderer.h"
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+    : m_Size(size)
 {
     GLCALL(glGenBuffers(1, &m_RendererID));
     GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
     GLCALL(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+    : m_Size(size)
+{
+    GLCALL(glGenBuffers(1, &m_RendererID));
+    GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLCALL(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
 VertexBuffer::~VertexBuffer()
 {
     glDeleteBuffers(1, &m_RendererID);
@@ -23,3 +32,18 @@ void VertexBuffer::UnBind() const
 {
     GLCALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+    ASSERT(size <= m_Size);
+    GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLCALL(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW));
+    GLCALL(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+}
+
+void VertexBuffer::SetSubData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    GLCALL(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLCALL(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
@@ -5,12 +5,20 @@ class VertexBuffer
 {
 public:
 	VertexBuffer(const void* data, unsigned int size);
+	// 动态缓冲：只分配空间，数据每帧通过 SetData 更新
+	VertexBuffer(unsigned int size);
 	~VertexBuffer();
 
 	void Bind() const;
 	void UnBind() const;
 
+	// 先丢弃旧存储（orphan）再写入，避免等待 GPU 读完上一批数据
+	void SetData(const void* data, unsigned int size);
+	// 写入一段数据，不丢弃缓冲中的其他内容，一般紧跟在 SetData 之后
+	void SetSubData(const void* data, unsigned int size, unsigned int offset);
+
 private:
 	unsigned int m_RendererID;
+	unsigned int m_Size;
 };
 
@@ -23,11 +23,24 @@ struct VertexBufferElement
 		case GL_FLOAT: return 4;
 		case GL_UNSIGNED_INT: return 4;
 		case GL_UNSIGNED_BYTE: return 1;
+		case GL_BYTE: return 1;
+		case GL_SHORT: return 2;
+		case GL_UNSIGNED_SHORT: return 2;
+		case GL_HALF_FLOAT: return 2;
+		case GL_INT_2_10_10_10_REV: return 4;
 		default:
 			ASSERT(false);
 			return 0;
 		}
 	}
+
+	// 整个属性占用的字节数，打包格式（如 GL_INT_2_10_10_10_REV）的 4 个分量共用 4 字节
+	unsigned int GetSize() const
+	{
+		if (type == GL_INT_2_10_10_10_REV)
+			return GetSizeOfType(type);
+		return GetSizeOfType(type) * count;
+	}
 };
 
 class VertexBufferLayout
@@ -64,6 +77,12 @@ public:
 		m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE) * count;
 	}
 
+	void Push(const VertexBufferElement& element)
+	{
+		m_Elements.push_back(element);
+		m_Stride += element.GetSize();
+	}
+
 	inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
 	inline unsigned int GetStride() const { return m_Stride; }
 
@@ -1,8 +1,8 @@
 #pragma once
 
 #include <vector>
-#include <functional>
 #include <string>
+#include "RenderScheduler.h"
 
 namespace Test
 {
@@ -15,6 +15,8 @@ namespace Test
 		virtual void OnUpdate(float deltaTime) {}
 		virtual void OnRender() {}
 		virtual void OnImGuiRender() {}
+		// 按需渲染模式下何时需要重绘测试画面
+		virtual RedrawPolicy GetRedrawPolicy() const { return RedrawPolicy::Continuous; }
 	};
 
 	class TestMenu : public Test
@@ -24,15 +26,17 @@ namespace Test
 		~TestMenu();
 
 		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::OnInput; }
 
 		template<typename T>
 		void ReigsterTest(const std::string& name)
 		{
-			m_Test.push_back(std::make_pair(name, []() { return new T(); }));
+			m_Test.emplace_back(name, []() -> Test* { return new T(); });
 		}
 
 	private:
 		Test*& m_CurrentTest;
-		std::vector<std::pair<std::string, std::function<Test* ()>>> m_Test;
+		// 无捕获的 lambda 直接转为函数指针，不需要 std::function
+		std::vector<std::pair<std::string, Test* (*)()>> m_Test;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "TestAllocations.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "ParticleSystem.h"
+#include "MemoryTracker.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace Test {
+
+	namespace {
+
+		// 预热帧：容器在这期间增长到稳定的容量
+		const int WarmupFrames = 60;
+
+	}
+
+	TestAllocations::TestAllocations()
+		: m_ProjectionMatrix(glm::ortho<float>(1920.f / 1080.f * -50.f, 1920.f / 1080.f * 50.f, -50.f, 50.f, -1.0f, 1.0f))
+		, m_BreakOnAllocation(false)
+	{
+		m_SpriteRenderer = std::make_unique<SpriteRenderer>();
+		m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+		m_Particles = std::make_unique<ParticleSystem>(50000);
+
+		std::mt19937 rng(12777);
+		std::uniform_real_distribution<float> x(-80.f, 80.f), y(-45.f, 45.f), depth(-0.9f, 0.9f);
+		for (int i = 0; i < 500; i++)
+		{
+			Sprite sprite;
+			sprite.Position = glm::vec3(x(rng), y(rng), depth(rng));
+			sprite.Size = glm::vec2(8.f, 6.f);
+			sprite.SpriteTexture = m_Texture.get();
+			m_Sprites.push_back(sprite);
+		}
+
+		Restart();
+	}
+
+	TestAllocations::~TestAllocations()
+	{
+	}
+
+	void TestAllocations::Restart()
+	{
+		m_Frame = 0;
+		m_UpdateAllocations = 0;
+		m_FrameAllocations = 0;
+		m_MaxFrameAllocations = 0;
+		m_TotalAllocations = 0;
+		m_FailedFrames = 0;
+		m_MeasuredFrames = 0;
+	}
+
+	void TestAllocations::OnUpdate(float deltaTime)
+	{
+		unsigned long long before = MemoryTracker::GetTotalAllocations();
+
+		ParticleEmitterSettings settings;
+		settings.Position = glm::vec2(0.f, -40.f);
+		settings.Speed = 60.f;
+		settings.Gravity = -30.f;
+		settings.Size = 0.5f;
+		m_Particles->Update(std::min(deltaTime, 0.05f), settings);
+
+		m_UpdateAllocations = MemoryTracker::GetTotalAllocations() - before;
+	}
+
+	void TestAllocations::OnRender()
+	{
+		unsigned long long before = MemoryTracker::GetTotalAllocations();
+
+		glClearColor(0.f, 0.f, 0.f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		m_SpriteRenderer->Begin(m_ProjectionMatrix);
+		for (const Sprite& sprite : m_Sprites)
+			m_SpriteRenderer->Submit(sprite);
+		m_SpriteRenderer->End();
+
+		ParticleEmitterSettings settings;
+		settings.Size = 0.5f;
+		m_Particles->Render(m_ProjectionMatrix, settings);
+
+		RecordFrame(m_UpdateAllocations + MemoryTracker::GetTotalAllocations() - before);
+	}
+
+	void TestAllocations::RecordFrame(unsigned long long allocations)
+	{
+		m_FrameAllocations = allocations;
+		if (++m_Frame <= WarmupFrames)
+			return;
+
+		m_MeasuredFrames++;
+		m_TotalAllocations += allocations;
+		m_MaxFrameAllocations = std::max(m_MaxFrameAllocations, allocations);
+		if (allocations > 0)
+		{
+			if (m_FailedFrames++ == 0)
+				std::cout << "Warring:: " << allocations << " heap allocations in steady-state frame " << m_Frame << std::endl;
+			if (m_BreakOnAllocation)
+				ASSERT(false);
+		}
+	}
+
+	void TestAllocations::OnImGuiRender()
+	{
+		ImGui::Text("Sprites %d, CPU particles %u", (int)m_Sprites.size(), m_Particles->GetStats().Alive);
+		ImGui::Checkbox("Break On Allocation", &m_BreakOnAllocation);
+		if (ImGui::Button("Restart"))
+			Restart();
+
+		ImGui::Separator();
+		if (m_Frame <= WarmupFrames)
+		{
+			ImGui::Text("Warming up... %d / %d", m_Frame, WarmupFrames);
+			return;
+		}
+
+		bool passed = m_FailedFrames == 0;
+		ImGui::TextColored(passed ? ImVec4(0.4f, 1.f, 0.4f, 1.f) : ImVec4(1.f, 0.4f, 0.4f, 1.f),
+			passed ? "PASS: 0 heap allocations in %d frames" : "FAIL: allocations in %d frames", passed ? m_MeasuredFrames : m_FailedFrames);
+		ImGui::Text("This Frame: %llu  Max: %llu  Total: %llu", m_FrameAllocations, m_MaxFrameAllocations, m_TotalAllocations);
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Test.h"
+#include "SpriteRenderer.h"
+#include "glm/glm.hpp"
+#include <memory>
+#include <vector>
+
+class Texture;
+class ParticleSystem;
+
+namespace Test {
+
+	// 稳态渲染路径零堆分配检查：预热后统计每帧 OnUpdate + OnRender 中的 operator new 次数，
+	// 不为 0 即判定失败（可选择直接断点）
+	class TestAllocations : public Test
+	{
+	public:
+		TestAllocations();
+		~TestAllocations();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		void Restart();
+		void RecordFrame(unsigned long long allocations);
+
+	private:
+		std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
+		std::unique_ptr<ParticleSystem> m_Particles;
+		std::unique_ptr<Texture> m_Texture;
+		std::vector<Sprite> m_Sprites;
+		glm::mat4 m_ProjectionMatrix;
+
+		bool m_BreakOnAllocation;
+		int m_Frame;
+		unsigned long long m_UpdateAllocations;
+		unsigned long long m_FrameAllocations;
+		unsigned long long m_MaxFrameAllocations;
+		unsigned long long m_TotalAllocations;
+		int m_FailedFrames;
+		int m_MeasuredFrames;
+	};
+
+}
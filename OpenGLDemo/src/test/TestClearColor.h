@@ -15,6 +15,7 @@ namespace Test {
 		virtual void OnUpdate(float deltaTime) override;
 		virtual void OnRender() override;
 		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::OnInput; }
 
 	private:
 		glm::vec4 m_ClearColor;
@@ -0,0 +1,340 @@
+#include "TestMesh.h"
+
+#include "Renderer.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Test {
+
+	namespace {
+
+		double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+	}
+
+	TestMesh::TestMesh()
+		: m_BenchmarkGridSize(1000)
+		, m_Rotation(20.f, 30.f, 0.f)
+		, m_Scale(1.f)
+		, m_Center(0.f)
+		, m_ProjectionMatrix(glm::perspective(glm::radians(45.f), 1920.f / 1080.f, 0.1f, 100.f))
+		, m_ViewMatrix(glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, -3.f)))
+		, m_GenerateMilliseconds(0.0)
+		, m_UploadMilliseconds(0.0)
+		, m_CookMilliseconds(0.0)
+		, m_CookedLoadMilliseconds(0.0)
+		, m_Optimized(false)
+		, m_BenchmarkFramebuffer(0)
+		, m_BenchmarkColorBuffer(0)
+		, m_BenchmarkDepthBuffer(0)
+		, m_OriginalRenderMilliseconds(0.0)
+		, m_OptimizedRenderMilliseconds(0.0)
+	{
+		snprintf(m_FilePath, sizeof(m_FilePath), "%s", "res/meshes/Cube.obj");
+
+		m_ShaderProgram = std::make_unique<Shader>("res/shaders/Mesh.shader");
+
+		ImportObj();
+	}
+
+	TestMesh::~TestMesh()
+	{
+		if (m_BenchmarkFramebuffer)
+		{
+			glDeleteFramebuffers(1, &m_BenchmarkFramebuffer);
+			glDeleteRenderbuffers(1, &m_BenchmarkColorBuffer);
+			glDeleteRenderbuffers(1, &m_BenchmarkDepthBuffer);
+		}
+	}
+
+	void TestMesh::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestMesh::OnRender()
+	{
+		glClearColor(0.1f, 0.1f, 0.1f, 1.f);
+		glEnable(GL_DEPTH_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		if (m_Mesh)
+		{
+			glm::mat4 modelMatrix = GetModelMatrix();
+
+			m_ShaderProgram->Bind();
+			m_ShaderProgram->SetUniformMat4f("u_MVP", m_ProjectionMatrix * m_ViewMatrix * modelMatrix * m_Mesh->GetDequantizeMatrix());
+			m_ShaderProgram->SetUniformMat4f("u_Model", modelMatrix);
+			m_ShaderProgram->SetUniform4f("u_Color", 0.8f, 0.8f, 0.8f, 1.f);
+
+			Renderer renderer;
+			renderer.Draw(m_Mesh->GetVertexArray(), m_Mesh->GetIndexBuffer(), m_ShaderProgram.get());
+		}
+
+		glDisable(GL_DEPTH_TEST);
+	}
+
+	void TestMesh::OnImGuiRender()
+	{
+		ImGui::InputText("OBJ File", m_FilePath, sizeof(m_FilePath));
+		if (ImGui::Button("Import OBJ"))
+			ImportObj();
+		ImGui::SameLine();
+		if (ImGui::Button("Cook"))
+			CookMesh();
+		ImGui::SameLine();
+		if (ImGui::Button("Load Cooked"))
+			LoadCookedMesh();
+
+		ImGui::SliderInt("Benchmark Grid", &m_BenchmarkGridSize, 100, 2000);
+		if (ImGui::Button("Generate Benchmark OBJ"))
+			GenerateBenchmarkObj();
+		if (m_GenerateMilliseconds > 0.0)
+			ImGui::Text("Generated %d triangles in %.1f ms", m_BenchmarkGridSize * m_BenchmarkGridSize * 2, m_GenerateMilliseconds);
+
+		ImGui::Separator();
+		ImGui::Text("File: %.2f MB, %u threads", m_ImportStats.FileSize / (1024.0 * 1024.0), m_ImportStats.ThreadCount);
+		ImGui::Text("Parse: %.2f ms (%.1f MB/s)", m_ImportStats.ParseMilliseconds, m_ImportStats.GetParseThroughput());
+		ImGui::Text("Build/dedup: %.2f ms, %u corners -> %u vertices", m_ImportStats.BuildMilliseconds, m_ImportStats.CornerCount, m_MeshData.VertexCount);
+		ImGui::Text("Triangles: %u", (unsigned int)(m_MeshData.Indices.size() / 3));
+		ImGui::Text("Upload: %.2f ms", m_UploadMilliseconds);
+		ImGui::Text("Cook: %.2f ms", m_CookMilliseconds);
+		ImGui::Text("Cooked load (map + upload): %.2f ms", m_CookedLoadMilliseconds);
+
+		ImGui::Separator();
+		ImGui::Checkbox("Vertex Cache", &m_OptimizeSettings.VertexCache);
+		ImGui::SameLine();
+		ImGui::Checkbox("Overdraw", &m_OptimizeSettings.Overdraw);
+		ImGui::SameLine();
+		ImGui::Checkbox("Vertex Fetch", &m_OptimizeSettings.VertexFetch);
+		ImGui::Checkbox("16-bit Indices", &m_OptimizeSettings.ShortIndices);
+		ImGui::SameLine();
+		ImGui::Checkbox("Quantize", &m_OptimizeSettings.Quantize);
+		ImGui::SliderFloat("Overdraw Threshold", &m_OptimizeSettings.OverdrawThreshold, 1.f, 1.5f);
+		if (ImGui::Button("Optimize") && !m_Optimized)
+			OptimizeMesh();
+		ImGui::SameLine();
+		if (ImGui::Button("Benchmark Render"))
+			RunRenderBenchmark();
+		if (m_Optimized)
+		{
+			const MeshOptimizeReport& report = m_OptimizeReport;
+			ImGui::Text("Optimize: %.2f ms, %u overdraw clusters", report.Milliseconds, report.ClusterCount);
+			ImGui::Text("ACMR: %.3f -> %.3f  ATVR: %.3f -> %.3f", report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR);
+			ImGui::Text("Vertex bytes: %u -> %u", report.VertexBytesBefore, report.VertexBytesAfter);
+			ImGui::Text("Index bytes: %u -> %u", report.IndexBytesBefore, report.IndexBytesAfter);
+			ImGui::Text("Saved: %.2f MB", report.GetBytesSaved() / (1024.0 * 1024.0));
+		}
+		if (m_OriginalRenderMilliseconds > 0.0)
+			ImGui::Text("Render (offscreen): original %.3f ms, optimized %.3f ms", m_OriginalRenderMilliseconds, m_OptimizedRenderMilliseconds);
+
+		ImGui::Separator();
+		ImGui::SliderFloat3("Rotation", &m_Rotation[0], -180.f, 180.f);
+		ImGui::SliderFloat("Scale", &m_Scale, 0.01f, 10.f, "%.3f", 3.f);
+	}
+
+	void TestMesh::GenerateBenchmarkObj()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// 起伏的网格平面，每个格子一个四边形面
+		const int n = m_BenchmarkGridSize;
+		const std::string path = "res/meshes/Benchmark.obj";
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		std::vector<char> buffer(1 << 20);
+		size_t used = 0;
+		auto flush = [&](size_t reserve)
+		{
+			if (used + reserve > buffer.size())
+			{
+				stream.write(buffer.data(), used);
+				used = 0;
+			}
+		};
+
+		for (int y = 0; y <= n; y++)
+		{
+			for (int x = 0; x <= n; x++)
+			{
+				float u = (float)x / n, v = (float)y / n;
+				float h = 0.05f * std::sin(u * 20.f) * std::cos(v * 20.f);
+				flush(256);
+				used += snprintf(&buffer[used], 256, "v %f %f %f\nvt %f %f\nvn 0 1 0\n", u - 0.5f, h, v - 0.5f, u, v);
+			}
+		}
+		for (int y = 0; y < n; y++)
+		{
+			for (int x = 0; x < n; x++)
+			{
+				int a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 2, d = a + n + 1;
+				flush(256);
+				used += snprintf(&buffer[used], 256, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, d, d, d, c, c, c, b, b, b);
+			}
+		}
+		stream.write(buffer.data(), used);
+		stream.close();
+
+		m_GenerateMilliseconds = MillisecondsSince(start);
+		snprintf(m_FilePath, sizeof(m_FilePath), "%s", path.c_str());
+	}
+
+	void TestMesh::ImportObj()
+	{
+		m_ImportStats = MeshImportStats();
+		if (!MeshImporter::LoadObj(m_FilePath, m_MeshData, &m_ImportStats))
+			return;
+
+		// 根据包围盒把模型缩放到视野内
+		glm::vec3 minBounds(m_MeshData.BoundsMin[0], m_MeshData.BoundsMin[1], m_MeshData.BoundsMin[2]);
+		glm::vec3 maxBounds(m_MeshData.BoundsMax[0], m_MeshData.BoundsMax[1], m_MeshData.BoundsMax[2]);
+		glm::vec3 extent = maxBounds - minBounds;
+		float size = std::max(extent.x, std::max(extent.y, extent.z));
+		m_Center = (minBounds + maxBounds) * 0.5f;
+		m_Scale = size > 0.f ? 1.5f / size : 1.f;
+
+		m_Optimized = false;
+		m_OriginalMesh.reset();
+		m_OriginalRenderMilliseconds = m_OptimizedRenderMilliseconds = 0.0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		m_Mesh = std::make_unique<Mesh>(m_MeshData);
+		glFinish();
+		m_UploadMilliseconds = MillisecondsSince(start);
+	}
+
+	void TestMesh::CookMesh()
+	{
+		if (m_MeshData.Indices.empty())
+			return;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		MeshImporter::WriteCooked(GetCookedPath(), m_MeshData);
+		m_CookMilliseconds = MillisecondsSince(start);
+	}
+
+	void TestMesh::LoadCookedMesh()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		std::unique_ptr<Mesh> mesh = Mesh::LoadCooked(GetCookedPath());
+		glFinish();
+		m_CookedLoadMilliseconds = MillisecondsSince(start);
+
+		if (mesh)
+			m_Mesh = std::move(mesh);
+	}
+
+	void TestMesh::OptimizeMesh()
+	{
+		if (!m_Mesh || m_MeshData.Indices.empty())
+			return;
+
+		m_OriginalMesh = std::move(m_Mesh);
+		m_OptimizeReport = MeshOptimizer::Optimize(m_MeshData, m_OptimizeSettings);
+		m_Mesh = std::make_unique<Mesh>(m_MeshData);
+		m_Optimized = true;
+	}
+
+	void TestMesh::RunRenderBenchmark()
+	{
+		if (!m_Mesh)
+			return;
+
+		m_OriginalRenderMilliseconds = MeasureRenderTime(m_OriginalMesh ? *m_OriginalMesh : *m_Mesh);
+		m_OptimizedRenderMilliseconds = MeasureRenderTime(*m_Mesh);
+	}
+
+	double TestMesh::MeasureRenderTime(const Mesh& mesh)
+	{
+		const int width = 1920, height = 1080, drawCount = 16;
+
+		if (!m_BenchmarkFramebuffer)
+		{
+			glGenRenderbuffers(1, &m_BenchmarkColorBuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, m_BenchmarkColorBuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+			glGenRenderbuffers(1, &m_BenchmarkDepthBuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, m_BenchmarkDepthBuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+			glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+			GLCALL(glGenFramebuffers(1, &m_BenchmarkFramebuffer));
+			glBindFramebuffer(GL_FRAMEBUFFER, m_BenchmarkFramebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_BenchmarkColorBuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_BenchmarkDepthBuffer);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				std::cout << "Warring:: benchmark framebuffer is incomplete" << std::endl;
+		}
+
+		GLint lastViewport[4], lastFramebuffer;
+		glGetIntegerv(GL_VIEWPORT, lastViewport);
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &lastFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_BenchmarkFramebuffer);
+		glViewport(0, 0, width, height);
+		glEnable(GL_DEPTH_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		glm::mat4 modelMatrix = GetModelMatrix();
+		m_ShaderProgram->Bind();
+		m_ShaderProgram->SetUniformMat4f("u_MVP", m_ProjectionMatrix * m_ViewMatrix * modelMatrix * mesh.GetDequantizeMatrix());
+		m_ShaderProgram->SetUniformMat4f("u_Model", modelMatrix);
+		m_ShaderProgram->SetUniform4f("u_Color", 0.8f, 0.8f, 0.8f, 1.f);
+
+		Renderer renderer;
+		renderer.Draw(mesh.GetVertexArray(), mesh.GetIndexBuffer(), m_ShaderProgram.get());
+		glFinish();
+
+		// 每次绘制前清除深度，保证每次绘制的片段工作量相同
+		GLuint query;
+		glGenQueries(1, &query);
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		for (int i = 0; i < drawCount; i++)
+		{
+			glClear(GL_DEPTH_BUFFER_BIT);
+			renderer.Draw(mesh.GetVertexArray(), mesh.GetIndexBuffer(), m_ShaderProgram.get());
+		}
+		glEndQuery(GL_TIME_ELAPSED);
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+		glDeleteQueries(1, &query);
+
+		glDisable(GL_DEPTH_TEST);
+		glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+		glViewport(lastViewport[0], lastViewport[1], lastViewport[2], lastViewport[3]);
+
+		return elapsed / 1000000.0 / drawCount;
+	}
+
+	glm::mat4 TestMesh::GetModelMatrix() const
+	{
+		glm::mat4 modelMatrix(1.f);
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(m_Rotation.x), glm::vec3(1.f, 0.f, 0.f));
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(m_Rotation.y), glm::vec3(0.f, 1.f, 0.f));
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(m_Rotation.z), glm::vec3(0.f, 0.f, 1.f));
+		modelMatrix = glm::scale(modelMatrix, glm::vec3(m_Scale));
+		modelMatrix = glm::translate(modelMatrix, -m_Center);
+		return modelMatrix;
+	}
+
+	std::string TestMesh::GetCookedPath() const
+	{
+		std::string path = m_FilePath;
+		size_t dot = path.find_last_of('.');
+		if (dot != std::string::npos && path.find_first_of("/\\", dot) == std::string::npos)
+			path.erase(dot);
+		return path + ".mesh";
+	}
+
+}
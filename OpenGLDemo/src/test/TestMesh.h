@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Test.h"
+#include "MeshImporter.h"
+#include "MeshOptimizer.h"
+#include "glm/glm.hpp"
+#include <memory>
+
+class Mesh;
+class Shader;
+
+namespace Test {
+
+	class TestMesh : public Test
+	{
+	public:
+		TestMesh();
+		~TestMesh();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::OnInput; }
+
+	private:
+		void GenerateBenchmarkObj();
+		void ImportObj();
+		void CookMesh();
+		void LoadCookedMesh();
+		void OptimizeMesh();
+		void RunRenderBenchmark();
+		double MeasureRenderTime(const Mesh& mesh);
+		glm::mat4 GetModelMatrix() const;
+		std::string GetCookedPath() const;
+
+	private:
+		char m_FilePath[256];
+		int m_BenchmarkGridSize;
+		glm::vec3 m_Rotation;
+		float m_Scale;
+		glm::vec3 m_Center;
+		glm::mat4 m_ProjectionMatrix, m_ViewMatrix;
+
+		MeshData m_MeshData;
+		MeshImportStats m_ImportStats;
+		double m_GenerateMilliseconds;
+		double m_UploadMilliseconds;
+		double m_CookMilliseconds;
+		double m_CookedLoadMilliseconds;
+
+		MeshOptimizeSettings m_OptimizeSettings;
+		MeshOptimizeReport m_OptimizeReport;
+		bool m_Optimized;
+
+		// 离屏渲染计时：绘制到 1920x1080 的 FBO，用 GL_TIME_ELAPSED 查询 GPU 时间
+		unsigned int m_BenchmarkFramebuffer;
+		unsigned int m_BenchmarkColorBuffer, m_BenchmarkDepthBuffer;
+		double m_OriginalRenderMilliseconds;
+		double m_OptimizedRenderMilliseconds;
+
+		std::unique_ptr<Mesh> m_Mesh;
+		std::unique_ptr<Mesh> m_OriginalMesh;
+		std::unique_ptr<Shader> m_ShaderProgram;
+	};
+
+}
@@ -0,0 +1,267 @@
+#include "TestOnDemand.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Test {
+
+	namespace {
+
+		const int Columns = 6;
+		const int Rows = 4;
+		const int CellMargin = 12;
+
+		bool Intersects(const DamageRect& a, const DamageRect& b)
+		{
+			return a.X < b.X + b.Width && b.X < a.X + a.Width && a.Y < b.Y + b.Height && b.Y < a.Y + a.Height;
+		}
+
+		glm::vec4 RandomColor(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> unit(0.3f, 1.f);
+			return glm::vec4(unit(random), unit(random), unit(random), 1.f);
+		}
+
+	}
+
+	TestOnDemand::TestOnDemand()
+		: m_Random(9527)
+		, m_Time(0.0)
+		, m_ViewportWidth(1920)
+		, m_ViewportHeight(1080)
+		, m_SpritesPerCell(200)
+		, m_Animate(false)
+		, m_AnimatedCell(0)
+		, m_AnimationPhase(0.f)
+		, m_LoadDone(false)
+		, m_Updates(0)
+		, m_CellsDrawn(0)
+		, m_TotalCellsDrawn(0)
+		, m_RenderMilliseconds(0.0)
+	{
+		m_SpriteRenderer = std::make_unique<SpriteRenderer>();
+		const unsigned char white[4] = { 255, 255, 255, 255 };
+		m_WhiteTexture = std::make_unique<Texture>(1, 1, white);
+		m_LogoTexture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+
+		std::uniform_real_distribution<float> value(0.1f, 1.f);
+		std::uniform_real_distribution<double> interval(1.0, 4.0);
+		m_Cells.resize(Columns * Rows);
+		for (Cell& cell : m_Cells)
+		{
+			cell.Value = value(m_Random);
+			cell.NextUpdate = interval(m_Random);
+			cell.Color = RandomColor(m_Random);
+		}
+	}
+
+	TestOnDemand::~TestOnDemand()
+	{
+		if (m_LoadThread.joinable())
+			m_LoadThread.join();
+	}
+
+	DamageRect TestOnDemand::GetCellRect(int cell) const
+	{
+		int cellWidth = (m_ViewportWidth - CellMargin) / Columns;
+		int cellHeight = (m_ViewportHeight - CellMargin) / Rows;
+
+		DamageRect rect;
+		rect.X = CellMargin + (cell % Columns) * cellWidth;
+		rect.Y = CellMargin + (cell / Columns) * cellHeight;
+		rect.Width = std::max(cellWidth - CellMargin, 1);
+		rect.Height = std::max(cellHeight - CellMargin, 1);
+		return rect;
+	}
+
+	void TestOnDemand::InvalidateCell(int cell)
+	{
+		DamageRect rect = GetCellRect(cell);
+		RenderScheduler::Get().Invalidate(rect.X, rect.Y, rect.Width, rect.Height);
+	}
+
+	void TestOnDemand::StartLoad()
+	{
+		if (m_LoadThread.joinable())
+			return;
+
+		m_LoadDone = false;
+		unsigned int seed = m_Random();
+		m_LoadThread = std::thread([this, seed]()
+		{
+			// 模拟读取文件或网络请求
+			std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+			std::mt19937 random(seed);
+			m_LoadedPalette.resize(m_Cells.size());
+			for (glm::vec4& color : m_LoadedPalette)
+				color = RandomColor(random);
+
+			m_LoadDone = true;
+			RenderScheduler::Get().WakeFromThread();
+		});
+	}
+
+	void TestOnDemand::OnUpdate(float deltaTime)
+	{
+		RenderScheduler& scheduler = RenderScheduler::Get();
+		m_Time += deltaTime;
+
+		std::uniform_real_distribution<float> value(0.1f, 1.f);
+		std::uniform_real_distribution<double> interval(1.0, 4.0);
+		double nextUpdate = std::numeric_limits<double>::infinity();
+		for (int i = 0; i < (int)m_Cells.size(); i++)
+		{
+			Cell& cell = m_Cells[i];
+			if (m_Time >= cell.NextUpdate)
+			{
+				cell.Value = value(m_Random);
+				cell.NextUpdate = m_Time + interval(m_Random);
+				InvalidateCell(i);
+				m_Updates++;
+			}
+			nextUpdate = std::min(nextUpdate, cell.NextUpdate);
+		}
+
+		if (m_LoadThread.joinable() && m_LoadDone)
+		{
+			m_LoadThread.join();
+			for (size_t i = 0; i < m_Cells.size(); i++)
+				m_Cells[i].Color = m_LoadedPalette[i];
+			scheduler.Invalidate();
+		}
+
+		if (m_Animate)
+		{
+			m_AnimationPhase += deltaTime;
+			InvalidateCell(m_AnimatedCell);
+			scheduler.RequestAnimationFrame();
+		}
+		else
+		{
+			scheduler.WakeAfter(nextUpdate - m_Time);
+		}
+	}
+
+	void TestOnDemand::OnRender()
+	{
+		glClearColor(0.08f, 0.08f, 0.1f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		if (viewport[2] != m_ViewportWidth || viewport[3] != m_ViewportHeight)
+		{
+			// 布局变化，下一帧整体重绘
+			m_ViewportWidth = viewport[2];
+			m_ViewportHeight = viewport[3];
+			RenderScheduler::Get().Invalidate();
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// 只提交与损坏区域相交的格子，其余部分被 scissor 挡住也不需要绘制
+		const DamageRect& damage = RenderScheduler::Get().GetDamageBounds();
+		m_SpriteRenderer->Begin(glm::ortho(0.f, (float)m_ViewportWidth, 0.f, (float)m_ViewportHeight, -1.f, 1.f));
+		m_CellsDrawn = 0;
+		for (int i = 0; i < (int)m_Cells.size(); i++)
+		{
+			DamageRect rect = GetCellRect(i);
+			if (!Intersects(rect, damage))
+				continue;
+
+			const Cell& cell = m_Cells[i];
+			m_CellsDrawn++;
+
+			float value = cell.Value;
+			glm::vec4 color = cell.Color;
+			if (m_Animate && i == m_AnimatedCell)
+			{
+				value = 0.55f + 0.45f * std::sin(m_AnimationPhase * 3.f);
+				color = glm::vec4(1.f, 0.5f + 0.5f * std::sin(m_AnimationPhase * 5.f), 0.2f, 1.f);
+			}
+
+			glm::vec2 center(rect.X + rect.Width * 0.5f, rect.Y + rect.Height * 0.5f);
+			Sprite background;
+			background.Position = glm::vec3(center, 0.f);
+			background.Size = glm::vec2((float)rect.Width, (float)rect.Height);
+			background.SpriteTexture = m_WhiteTexture.get();
+			background.Color = glm::vec4(glm::vec3(color) * 0.25f, 1.f);
+			m_SpriteRenderer->Submit(background);
+
+			float barHeight = rect.Height * 0.8f * value;
+			Sprite bar;
+			bar.Position = glm::vec3(center.x, rect.Y + rect.Height * 0.1f + barHeight * 0.5f, 0.1f);
+			bar.Size = glm::vec2(rect.Width * 0.6f, barHeight);
+			bar.SpriteTexture = m_WhiteTexture.get();
+			bar.Color = color;
+			m_SpriteRenderer->Submit(bar);
+
+			// 固定种子，同一个格子每次重绘的内容相同
+			std::mt19937 random(i);
+			std::uniform_real_distribution<float> x(rect.X + 16.f, rect.X + rect.Width - 16.f);
+			std::uniform_real_distribution<float> y(rect.Y + 16.f, rect.Y + rect.Height - 16.f);
+			for (int s = 0; s < m_SpritesPerCell; s++)
+			{
+				Sprite logo;
+				logo.Position = glm::vec3(x(random), y(random), 0.2f);
+				logo.Size = glm::vec2(24.f, 24.f);
+				logo.SpriteTexture = m_LogoTexture.get();
+				logo.Color = glm::vec4(1.f, 1.f, 1.f, 1.f);
+				m_SpriteRenderer->Submit(logo);
+			}
+		}
+		m_SpriteRenderer->End();
+		m_TotalCellsDrawn += m_CellsDrawn;
+
+		auto end = std::chrono::high_resolution_clock::now();
+		m_RenderMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	void TestOnDemand::OnImGuiRender()
+	{
+		RenderScheduler& scheduler = RenderScheduler::Get();
+		bool onDemand = scheduler.IsOnDemand();
+		if (ImGui::Checkbox("On-Demand", &onDemand))
+			scheduler.SetOnDemand(onDemand);
+		ImGui::SameLine();
+		bool partialRedraw = scheduler.IsPartialRedraw();
+		if (ImGui::Checkbox("Partial Redraw", &partialRedraw))
+			scheduler.SetPartialRedraw(partialRedraw);
+
+		if (ImGui::SliderInt("Sprites / Cell", &m_SpritesPerCell, 0, 2000))
+			scheduler.Invalidate();
+		if (ImGui::Checkbox("Animate", &m_Animate))
+			InvalidateCell(m_AnimatedCell);
+		ImGui::SameLine();
+		if (ImGui::SliderInt("Cell", &m_AnimatedCell, 0, Columns * Rows - 1))
+			scheduler.Invalidate();
+
+		if (m_LoadThread.joinable())
+		{
+			ImGui::Text("Loading palette...");
+		}
+		else if (ImGui::Button("Load Palette (async)"))
+		{
+			StartLoad();
+		}
+
+		ImGui::Separator();
+		const RenderSchedulerStats& stats = scheduler.GetStats();
+		ImGui::Text("Value updates: %u", m_Updates);
+		ImGui::Text("Cells drawn: %u / %d last redraw, %llu total", m_CellsDrawn, Columns * Rows, m_TotalCellsDrawn);
+		ImGui::Text("Submit: %.3f ms", m_RenderMilliseconds);
+		ImGui::Text("Frames: %llu active, %llu idle wakeups, %llu content (%llu partial)",
+			stats.ActiveFrames, stats.IdleWakeups, stats.ContentFrames, stats.PartialFrames);
+		const RenderModeStats& mode = scheduler.IsOnDemand() ? stats.OnDemand : stats.Continuous;
+		if (mode.Measured)
+			ImGui::Text("CPU %.1f%%, %.1f frames/s, %.1f idle wakeups/s", mode.CpuPercent, mode.FramesPerSecond, mode.WakeupsPerSecond);
+	}
+
+}
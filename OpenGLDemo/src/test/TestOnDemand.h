@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Test.h"
+#include "SpriteRenderer.h"
+#include "glm/glm.hpp"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+class Texture;
+
+namespace Test {
+
+	// 按需渲染演示：仪表盘的格子每隔 1~4 秒随机更新一次，只把变化的格子报告为损坏区域。
+	// 开启按需渲染后没有更新时主循环休眠，开启局部重绘后每次只重绘变化的格子
+	class TestOnDemand : public Test
+	{
+	public:
+		TestOnDemand();
+		~TestOnDemand();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::Explicit; }
+
+	private:
+		struct Cell
+		{
+			float Value;
+			double NextUpdate;
+			glm::vec4 Color;
+		};
+
+		DamageRect GetCellRect(int cell) const;
+		void InvalidateCell(int cell);
+		void StartLoad();
+
+	private:
+		std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
+		std::unique_ptr<Texture> m_WhiteTexture, m_LogoTexture;
+		std::vector<Cell> m_Cells;
+		std::mt19937 m_Random;
+		double m_Time;
+		int m_ViewportWidth, m_ViewportHeight;
+
+		int m_SpritesPerCell;       // 每个格子额外绘制的精灵，模拟绘制开销
+		bool m_Animate;
+		int m_AnimatedCell;
+		float m_AnimationPhase;
+
+		// 模拟异步加载：后台线程完成后唤醒主循环，由 OnUpdate 应用结果
+		std::thread m_LoadThread;
+		std::atomic<bool> m_LoadDone;
+		std::vector<glm::vec4> m_LoadedPalette;
+
+		unsigned int m_Updates;
+		unsigned int m_CellsDrawn;          // 最近一次重绘的格子数
+		unsigned long long m_TotalCellsDrawn;
+		double m_RenderMilliseconds;
+	};
+
+}
@@ -0,0 +1,137 @@
+#include "TestParticles.h"
+
+#include "Renderer.h"
+#include "GPUParticleSystem.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace Test {
+
+	TestParticles::TestParticles()
+		: m_Mode(0)
+		, m_Capacity(200000)
+		, m_UseSIMD(true)
+		, m_UseThreads(true)
+		, m_Paused(false)
+		, m_UpdateMilliseconds(0.0)
+		, m_RenderMilliseconds(0.0)
+	{
+		m_Settings.Position = glm::vec2(0.f, -350.f);
+		m_Settings.Speed = 700.f;
+		m_Settings.Spread = 0.8f;
+		m_Settings.Lifetime = 2.5f;
+		m_Settings.Gravity = -350.f;
+		m_Settings.Drag = 0.3f;
+		m_Settings.Size = 3.f;
+
+		CreateSystems();
+	}
+
+	TestParticles::~TestParticles()
+	{
+	}
+
+	void TestParticles::CreateSystems()
+	{
+		// 只保留当前模式的系统，百万级粒子的缓冲不小
+		m_CPUSystem.reset();
+		m_GPUSystem.reset();
+		if (m_Mode == 0)
+			m_CPUSystem = std::make_unique<ParticleSystem>((unsigned int)m_Capacity);
+		else
+			m_GPUSystem = std::make_unique<GPUParticleSystem>((unsigned int)m_Capacity);
+	}
+
+	void TestParticles::OnUpdate(float deltaTime)
+	{
+		if (m_Paused)
+			return;
+
+		// 卡顿（如拖动窗口）后限制步长，避免粒子一次飞出屏幕
+		deltaTime = std::min(deltaTime, 0.05f);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		if (m_CPUSystem)
+		{
+			m_CPUSystem->SetUseSIMD(m_UseSIMD);
+			m_CPUSystem->SetUseThreads(m_UseThreads);
+			m_CPUSystem->Update(deltaTime, m_Settings);
+		}
+		if (m_GPUSystem)
+			m_GPUSystem->Update(deltaTime, m_Settings);
+		m_UpdateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void TestParticles::OnRender()
+	{
+		glClearColor(0.02f, 0.02f, 0.04f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// 像素坐标，原点在窗口中心
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		float halfWidth = viewport[2] * 0.5f, halfHeight = viewport[3] * 0.5f;
+		glm::mat4 projection = glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, -1.f, 1.f);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		if (m_CPUSystem)
+			m_CPUSystem->Render(projection, m_Settings);
+		if (m_GPUSystem)
+			m_GPUSystem->Render(projection, m_Settings);
+		m_RenderMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void TestParticles::OnImGuiRender()
+	{
+		bool recreate = ImGui::Combo("Mode", &m_Mode, "CPU (SoA + SIMD + Threads)\0GPU (Transform Feedback)\0");
+		ImGui::SliderInt("Capacity", &m_Capacity, 10000, 2000000);
+		recreate |= ImGui::Button("Apply Capacity");
+		if (recreate)
+			CreateSystems();
+
+		ImGui::Checkbox("Paused", &m_Paused);
+		if (m_Mode == 0)
+		{
+			ImGui::SameLine();
+			if (ParticleSystem::IsSIMDSupported())
+				ImGui::Checkbox("SIMD", &m_UseSIMD);
+			else
+				ImGui::TextDisabled("SIMD (unsupported)");
+			ImGui::SameLine();
+			ImGui::Checkbox("Threads", &m_UseThreads);
+		}
+
+		if (ImGui::CollapsingHeader("Emitter"))
+		{
+			ImGui::SliderFloat2("Position", &m_Settings.Position[0], -900.f, 900.f);
+			ImGui::SliderAngle("Direction", &m_Settings.Direction, 0.f, 360.f);
+			ImGui::SliderAngle("Spread", &m_Settings.Spread, 0.f, 360.f);
+			ImGui::SliderFloat("Speed", &m_Settings.Speed, 0.f, 2000.f);
+			ImGui::SliderFloat("Lifetime", &m_Settings.Lifetime, 0.1f, 10.f);
+			ImGui::SliderFloat("Gravity", &m_Settings.Gravity, -1000.f, 1000.f);
+			ImGui::SliderFloat("Drag", &m_Settings.Drag, 0.f, 5.f);
+			ImGui::SliderFloat("Size", &m_Settings.Size, 1.f, 16.f);
+		}
+
+		ImGui::Separator();
+		if (m_CPUSystem)
+		{
+			const ParticleStats& stats = m_CPUSystem->GetStats();
+			ImGui::Text("Particles/Frame: %u (capacity %u)", stats.Alive, m_CPUSystem->GetCapacity());
+			ImGui::Text("Emitted %u  Removed %u  Threads %u", stats.Emitted, stats.Removed, m_CPUSystem->GetThreadCount());
+			ImGui::Text("Simulate: %.3f ms (%.1f M particles/s)", stats.SimulateMilliseconds,
+				stats.SimulateMilliseconds > 0.0 ? stats.Alive / stats.SimulateMilliseconds / 1000.0 : 0.0);
+			ImGui::Text("Compact: %.3f ms  Emit: %.3f ms  Upload: %.3f ms", stats.CompactMilliseconds, stats.EmitMilliseconds, stats.UploadMilliseconds);
+		}
+		if (m_GPUSystem)
+		{
+			ImGui::Text("Particles/Frame: %u", m_GPUSystem->GetCapacity());
+			ImGui::Text("Simulate (GPU): %.3f ms", m_GPUSystem->GetSimulateMilliseconds());
+		}
+		ImGui::Text("CPU Update: %.3f ms  CPU Render: %.3f ms", m_UpdateMilliseconds, m_RenderMilliseconds);
+	}
+
+}
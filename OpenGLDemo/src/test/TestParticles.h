@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+#include "ParticleSystem.h"
+#include <memory>
+
+class GPUParticleSystem;
+
+namespace Test {
+
+	// 粒子系统：CPU（SoA + SIMD + 多线程）与 GPU（transform feedback）两种模式对比
+	class TestParticles : public Test
+	{
+	public:
+		TestParticles();
+		~TestParticles();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		void CreateSystems();
+
+	private:
+		int m_Mode;                 // 0: CPU, 1: GPU
+		int m_Capacity;
+		bool m_UseSIMD;
+		bool m_UseThreads;
+		bool m_Paused;
+		ParticleEmitterSettings m_Settings;
+
+		std::unique_ptr<ParticleSystem> m_CPUSystem;
+		std::unique_ptr<GPUParticleSystem> m_GPUSystem;
+
+		double m_UpdateMilliseconds;
+		double m_RenderMilliseconds;
+	};
+
+}
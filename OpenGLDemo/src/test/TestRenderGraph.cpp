@@ -0,0 +1,294 @@
+#include "TestRenderGraph.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "RenderGraph.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace Test {
+
+	TestRenderGraph::TestRenderGraph()
+		: m_ProjectionMatrix(glm::ortho<float>(1920.f / 1080.f * -50.f, 1920.f / 1080.f * 50.f, -50.f, 50.f, -1.0f, 1.0f))
+		, m_Time(0.f)
+		, m_GraphWidth(0)
+		, m_GraphHeight(0)
+		, m_Bloom(true)
+		, m_ShowEdges(false)
+		, m_Aliasing(true)
+		, m_Invalidation(true)
+		, m_BlurIterations(3)
+		, m_Threshold(1.f)
+		, m_BloomIntensity(0.8f)
+		, m_Exposure(1.f)
+	{
+		m_Graph = std::make_unique<RenderGraph>();
+		m_SpriteRenderer = std::make_unique<SpriteRenderer>();
+		m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+		m_EmptyVAO = std::make_unique<VertexArray>();
+		m_PostShaders = std::make_unique<ShaderVariants>("res/shaders/PostProcess.shader");
+		// 先提交会用到的变体，支持并行编译时在第一次绘制前并行完成
+		m_PostShaders->Request(m_PostShaders->GetKey("THRESHOLD"));
+		m_PostShaders->Request(m_PostShaders->GetKey("BLUR"));
+		m_PostShaders->Request(m_PostShaders->GetKey("BLOOM"));
+
+		// 一部分精灵颜色大于 1，在 HDR 目标中产生 bloom
+		std::mt19937 rng(4242);
+		std::uniform_real_distribution<float> x(-80.f, 80.f), y(-45.f, 45.f), depth(-0.9f, 0.9f), intensity(0.5f, 4.f);
+		for (int i = 0; i < 200; i++)
+		{
+			Sprite sprite;
+			sprite.Position = glm::vec3(x(rng), y(rng), depth(rng));
+			sprite.Size = glm::vec2(12.f, 9.f);
+			sprite.SpriteTexture = m_Texture.get();
+			float scale = intensity(rng);
+			sprite.Color = glm::vec4(scale, scale * 0.8f, scale * 0.6f, 1.f);
+			m_Sprites.push_back(sprite);
+		}
+
+		BuildGraph();
+	}
+
+	TestRenderGraph::~TestRenderGraph()
+	{
+	}
+
+	void TestRenderGraph::DrawFullscreen() const
+	{
+		m_EmptyVAO->Bind();
+		GLCALL(glDrawArrays(GL_TRIANGLES, 0, 3));
+	}
+
+	void TestRenderGraph::BuildGraph()
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		int width = viewport[2] > 0 ? viewport[2] : 1920;
+		int height = viewport[3] > 0 ? viewport[3] : 1080;
+		m_GraphWidth = viewport[2];
+		m_GraphHeight = viewport[3];
+
+		m_Graph->Reset();
+		m_Graph->SetAliasing(m_Aliasing);
+		m_Graph->SetInvalidation(m_Invalidation);
+
+		RenderTargetDesc colorDesc;
+		colorDesc.Width = width;
+		colorDesc.Height = height;
+		colorDesc.Format = RenderTargetFormat::RGBA16F;
+		RenderTargetDesc depthDesc = colorDesc;
+		depthDesc.Format = RenderTargetFormat::Depth24Stencil8;
+		RenderTargetDesc halfDesc = colorDesc;
+		halfDesc.Width = width / 2;
+		halfDesc.Height = height / 2;
+		RenderTargetDesc edgeDesc = colorDesc;
+		edgeDesc.Format = RenderTargetFormat::R8;
+
+		RenderGraphResource backbuffer = m_Graph->ImportBackbuffer("Backbuffer", width, height);
+
+		// 场景
+		RenderGraphResource sceneColor = m_Graph->CreateTexture("SceneColor", colorDesc);
+		RenderGraphResource sceneDepth = m_Graph->CreateTexture("SceneDepth", depthDesc);
+		{
+			RenderGraphPassBuilder pass = m_Graph->AddPass("Scene");
+			pass.Write(sceneColor);
+			pass.Write(sceneDepth);
+			pass.SetExecute([this](RenderGraphContext&)
+			{
+				GLCALL(glClearColor(0.02f, 0.02f, 0.03f, 1.f));
+				GLCALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+				glm::mat4 view = glm::translate(glm::mat4(1.f), glm::vec3(std::sin(m_Time * 0.5f) * 10.f, 0.f, 0.f));
+				m_SpriteRenderer->Begin(m_ProjectionMatrix * view);
+				for (const Sprite& sprite : m_Sprites)
+					m_SpriteRenderer->Submit(sprite);
+				m_SpriteRenderer->End();
+			});
+		}
+
+		// 调试：边缘检测，只有合成时显示边缘才会被读取，否则整个 pass 被裁剪
+		RenderGraphResource edges = m_Graph->CreateTexture("Edges", edgeDesc);
+		{
+			RenderGraphPassBuilder pass = m_Graph->AddPass("Edges");
+			pass.Read(sceneColor);
+			pass.Write(edges);
+			unsigned int key = m_PostShaders->GetKey("EDGES");
+			pass.SetExecute([this, sceneColor, key](RenderGraphContext& context)
+			{
+				Shader* shader = m_PostShaders->Get(key);
+				if (!shader)
+					return;
+				shader->Bind();
+				context.BindTexture(sceneColor, 0);
+				shader->SetUniform1i("u_Source", 0);
+				DrawFullscreen();
+			});
+		}
+
+		// bloom：亮度阈值后在半分辨率上来回模糊，每次迭代两张临时纹理，生命周期依次错开
+		RenderGraphResource bloom = m_Graph->CreateTexture("Bright", halfDesc);
+		{
+			RenderGraphPassBuilder pass = m_Graph->AddPass("Threshold");
+			pass.Read(sceneColor);
+			pass.Write(bloom);
+			unsigned int key = m_PostShaders->GetKey("THRESHOLD");
+			pass.SetExecute([this, sceneColor, key](RenderGraphContext& context)
+			{
+				Shader* shader = m_PostShaders->Get(key);
+				if (!shader)
+					return;
+				shader->Bind();
+				context.BindTexture(sceneColor, 0);
+				shader->SetUniform1i("u_Source", 0);
+				shader->SetUniform1f("u_Threshold", m_Threshold);
+				DrawFullscreen();
+			});
+		}
+
+		unsigned int blurKey = m_PostShaders->GetKey("BLUR");
+		for (int i = 0; i < m_BlurIterations; i++)
+		{
+			for (int direction = 0; direction < 2; direction++)
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "Blur%c%d", direction == 0 ? 'H' : 'V', i);
+				RenderGraphResource source = bloom;
+				bloom = m_Graph->CreateTexture(name, halfDesc);
+
+				RenderGraphPassBuilder pass = m_Graph->AddPass(name);
+				pass.Read(source);
+				pass.Write(bloom);
+				glm::vec2 step = direction == 0 ? glm::vec2(1.f / halfDesc.Width, 0.f) : glm::vec2(0.f, 1.f / halfDesc.Height);
+				pass.SetExecute([this, source, step, blurKey](RenderGraphContext& context)
+				{
+					Shader* shader = m_PostShaders->Get(blurKey);
+					if (!shader)
+						return;
+					shader->Bind();
+					context.BindTexture(source, 0);
+					shader->SetUniform1i("u_Source", 0);
+					shader->SetUniform2f("u_Direction", step.x, step.y);
+					DrawFullscreen();
+				});
+			}
+		}
+
+		// 合成到默认帧缓冲
+		{
+			RenderGraphPassBuilder pass = m_Graph->AddPass("Composite");
+			pass.Read(sceneColor);
+			unsigned int key = 0;
+			if (m_Bloom)
+			{
+				pass.Read(bloom);
+				key |= m_PostShaders->GetKey("BLOOM");
+			}
+			if (m_ShowEdges)
+			{
+				pass.Read(edges);
+				key |= m_PostShaders->GetKey("SHOW_EDGES");
+			}
+			pass.Write(backbuffer);
+
+			bool useBloom = m_Bloom, useEdges = m_ShowEdges;
+			pass.SetExecute([this, sceneColor, bloom, edges, key, useBloom, useEdges](RenderGraphContext& context)
+			{
+				Shader* shader = m_PostShaders->Get(key);
+				if (!shader)
+					return;
+				shader->Bind();
+				context.BindTexture(sceneColor, 0);
+				shader->SetUniform1i("u_Source", 0);
+				shader->SetUniform1f("u_Exposure", m_Exposure);
+				if (useBloom)
+				{
+					context.BindTexture(bloom, 1);
+					shader->SetUniform1i("u_Bloom", 1);
+					shader->SetUniform1f("u_BloomIntensity", m_BloomIntensity);
+				}
+				if (useEdges)
+				{
+					context.BindTexture(edges, 2);
+					shader->SetUniform1i("u_Edges", 2);
+				}
+				DrawFullscreen();
+			});
+		}
+
+		m_Graph->Compile();
+	}
+
+	void TestRenderGraph::OnUpdate(float deltaTime)
+	{
+		m_Time += deltaTime;
+		m_PostShaders->Poll();
+	}
+
+	void TestRenderGraph::OnRender()
+	{
+		// 窗口大小变化后 backbuffer 和临时纹理都要按新尺寸重新分配
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		if (viewport[2] != m_GraphWidth || viewport[3] != m_GraphHeight)
+			BuildGraph();
+
+		m_Graph->Execute();
+	}
+
+	void TestRenderGraph::OnImGuiRender()
+	{
+		bool rebuild = false;
+		rebuild |= ImGui::Checkbox("Bloom", &m_Bloom);
+		rebuild |= ImGui::Checkbox("Show Edges (debug pass)", &m_ShowEdges);
+		rebuild |= ImGui::SliderInt("Blur Iterations", &m_BlurIterations, 1, 8);
+		rebuild |= ImGui::Checkbox("Aliasing", &m_Aliasing);
+		rebuild |= ImGui::Checkbox("Invalidate (discard hints)", &m_Invalidation);
+		if (rebuild)
+			BuildGraph();
+
+		ImGui::SliderFloat("Threshold", &m_Threshold, 0.f, 4.f);
+		ImGui::SliderFloat("Bloom Intensity", &m_BloomIntensity, 0.f, 2.f);
+		ImGui::SliderFloat("Exposure", &m_Exposure, 0.1f, 4.f);
+
+		const RenderGraphStats& stats = m_Graph->GetStats();
+		ImGui::Separator();
+		ImGui::Text("Passes: %u executed, %u culled", stats.Passes, stats.CulledPasses);
+		ImGui::Text("Transient textures: %u -> %u physical", stats.TransientTextures, stats.PhysicalTextures);
+		ImGui::Text("Peak transient memory without aliasing: %.2f MB", stats.TransientBytes / (1024.0 * 1024.0));
+		ImGui::Text("Peak transient memory allocated: %.2f MB", stats.PhysicalBytes / (1024.0 * 1024.0));
+		ImGui::Text("Invalidated attachments: %u %s", stats.InvalidatedAttachments, RenderGraph::IsInvalidationSupported() ? "" : "(not supported)");
+		ImGui::Text("Compile: %.3f ms", stats.CompileMilliseconds);
+
+		if (ImGui::TreeNode("Passes"))
+		{
+			for (unsigned int pass : m_Graph->GetExecutionOrder())
+				ImGui::BulletText("%s", m_Graph->GetPassName(pass).c_str());
+			for (unsigned int pass = 0; pass < m_Graph->GetPassCount(); pass++)
+			{
+				if (m_Graph->IsPassCulled(pass))
+					ImGui::TextDisabled("  %s (culled)", m_Graph->GetPassName(pass).c_str());
+			}
+			ImGui::TreePop();
+		}
+		if (ImGui::TreeNode("Resources"))
+		{
+			for (unsigned int resource = 0; resource < m_Graph->GetResourceCount(); resource++)
+			{
+				int physical = m_Graph->GetResourcePhysicalIndex(resource);
+				if (physical >= 0)
+					ImGui::BulletText("%s -> texture %d", m_Graph->GetResourceName(resource).c_str(), physical);
+				else
+					ImGui::TextDisabled("  %s", m_Graph->GetResourceName(resource).c_str());
+			}
+			ImGui::TreePop();
+		}
+	}
+
+}
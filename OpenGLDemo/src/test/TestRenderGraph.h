@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Test.h"
+#include "SpriteRenderer.h"
+#include "glm/glm.hpp"
+#include <memory>
+#include <vector>
+
+class Texture;
+class VertexArray;
+class Shader;
+class ShaderVariants;
+class RenderGraph;
+
+namespace Test {
+
+	// 用渲染图搭建的后处理链：场景 -> 亮度阈值 -> 多次高斯模糊 -> 合成，另有一个调试用的边缘检测 pass。
+	// 关闭 bloom 或边缘显示时对应的 pass 被裁剪；显示开启/关闭别名复用时临时纹理的峰值显存
+	class TestRenderGraph : public Test
+	{
+	public:
+		TestRenderGraph();
+		~TestRenderGraph();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		// 设置变化时重建并编译渲染图
+		void BuildGraph();
+		void DrawFullscreen() const;
+
+	private:
+		std::unique_ptr<RenderGraph> m_Graph;
+		std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
+		std::unique_ptr<Texture> m_Texture;
+		std::unique_ptr<VertexArray> m_EmptyVAO;
+		std::unique_ptr<ShaderVariants> m_PostShaders;
+		std::vector<Sprite> m_Sprites;
+		glm::mat4 m_ProjectionMatrix;
+		float m_Time;
+		int m_GraphWidth, m_GraphHeight;    // 渲染图按这个尺寸构建，视口变化时重建
+
+		bool m_Bloom;
+		bool m_ShowEdges;
+		bool m_Aliasing;
+		bool m_Invalidation;
+		int m_BlurIterations;
+		float m_Threshold;
+		float m_BloomIntensity;
+		float m_Exposure;
+	};
+
+}
@@ -0,0 +1,175 @@
+#include "TestShaderVariants.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+namespace Test {
+
+	namespace {
+
+		const char* ShaderPath = "res/shaders/Variants.shader";
+
+		double ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+	}
+
+	TestShaderVariants::TestShaderVariants()
+		: m_ProjectionMatrix(glm::ortho<float>(1920.f / 1080.f * -1.f, 1920.f / 1080.f * 1.f, -1.f, 1.f, -1.0f, 1.0f))
+		, m_DrawnKey(0)
+		, m_Salt(0)
+		, m_TexturedKey(0)
+		, m_TintKey(0)
+		, m_AnimateKey(0)
+		, m_Time(0.f)
+		, m_ParallelRunning(false)
+		, m_ParallelMilliseconds(0.0)
+		, m_SequentialMilliseconds(0.0)
+	{
+		float vertexBuffer[] = {
+			-0.8f, -0.8f, 0.f, 0.f,
+			-0.8f,  0.8f, 0.f, 1.f,
+			 0.8f,  0.8f, 1.f, 1.f,
+			 0.8f, -0.8f, 1.f, 0.f,
+		};
+
+		unsigned int indices[] = {
+			0, 1, 2,
+			2, 3, 0,
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertexBuffer, sizeof(vertexBuffer));
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+		m_IBO = std::make_unique<IndexBuffer>(indices, sizeof(indices) / sizeof(unsigned int));
+		m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+
+		for (bool& enabled : m_Enabled)
+			enabled = false;
+
+		Recreate();
+	}
+
+	TestShaderVariants::~TestShaderVariants()
+	{
+	}
+
+	void TestShaderVariants::Recreate()
+	{
+		m_Variants = std::make_unique<ShaderVariants>(ShaderPath, ++m_Salt);
+		m_TexturedKey = m_Variants->GetKey("TEXTURED");
+		m_TintKey = m_Variants->GetKey("TINT");
+		m_AnimateKey = m_Variants->GetKey("ANIMATE");
+		m_DrawnKey = 0;
+		m_ParallelRunning = false;
+	}
+
+	void TestShaderVariants::CompileAllParallel()
+	{
+		Recreate();
+		m_ParallelStart = std::chrono::high_resolution_clock::now();
+		if (!m_Variants->RequestAll())
+			return;
+		// 没有并行编译时 RequestAll 已经阻塞到全部完成
+		m_ParallelRunning = m_Variants->GetStats().Pending > 0;
+		if (!m_ParallelRunning)
+			m_ParallelMilliseconds = ElapsedMilliseconds(m_ParallelStart);
+	}
+
+	void TestShaderVariants::CompileAllSequential()
+	{
+		if (m_Variants->GetPermutationCount() > ShaderVariants::MaxRequestAllPermutations)
+			return;
+
+		Recreate();
+		auto start = std::chrono::high_resolution_clock::now();
+		unsigned int count = 1u << m_Variants->GetPermutationCount();
+		for (unsigned int key = 0; key < count; key++)
+			m_Variants->Get(key, true);
+		m_SequentialMilliseconds = ElapsedMilliseconds(start);
+	}
+
+	void TestShaderVariants::OnUpdate(float deltaTime)
+	{
+		m_Time += deltaTime;
+
+		m_Variants->Poll();
+		if (m_ParallelRunning && m_Variants->GetStats().Pending == 0)
+		{
+			// 精度受限于帧率，每帧才轮询一次
+			m_ParallelMilliseconds = ElapsedMilliseconds(m_ParallelStart);
+			m_ParallelRunning = false;
+		}
+	}
+
+	void TestShaderVariants::OnRender()
+	{
+		GLCALL(glClearColor(0.1f, 0.1f, 0.1f, 1.f));
+		GLCALL(glClear(GL_COLOR_BUFFER_BIT));
+
+		unsigned int key = 0;
+		for (unsigned int i = 0; i < m_Variants->GetPermutationCount(); i++)
+		{
+			if (m_Enabled[i])
+				key |= 1u << i;
+		}
+
+		// 不等待：请求的变体还在编译时继续画上一个变体
+		Shader* shader = m_Variants->Get(key, false);
+		if (shader)
+			m_DrawnKey = key;
+		else
+			shader = m_Variants->Get(m_DrawnKey, true);
+		if (!shader)
+			return;
+
+		shader->Bind();
+		shader->SetUniformMat4f("u_MVP", m_ProjectionMatrix);
+		if (m_DrawnKey & m_TexturedKey)
+		{
+			m_Texture->Bind(0);
+			shader->SetUniform1i("u_Texture", 0);
+		}
+		if (m_DrawnKey & m_TintKey)
+			shader->SetUniform4f("u_Color", 1.f, 0.6f, 0.3f, 1.f);
+		if (m_DrawnKey & m_AnimateKey)
+			shader->SetUniform1f("u_Time", m_Time);
+
+		Renderer renderer;
+		renderer.Draw(m_VAO.get(), m_IBO.get(), shader);
+	}
+
+	void TestShaderVariants::OnImGuiRender()
+	{
+		ImGui::Text("Parallel compile: %s", Shader::IsParallelCompileEnabled() ? "available" : "not available");
+
+		for (unsigned int i = 0; i < m_Variants->GetPermutationCount(); i++)
+			ImGui::Checkbox(m_Variants->GetPermutationName(i).c_str(), &m_Enabled[i]);
+		ImGui::Text("Drawn variant: 0x%02X", m_DrawnKey);
+
+		if (ImGui::Button("Compile All (parallel)"))
+			CompileAllParallel();
+		ImGui::SameLine();
+		if (ImGui::Button("Compile All (sequential)"))
+			CompileAllSequential();
+
+		const ShaderVariantStats& stats = m_Variants->GetStats();
+		ImGui::Text("Variants: %u  pending: %u  failed: %u", stats.Variants, stats.Pending, stats.Failed);
+		ImGui::Text("Preprocess: %.3f ms  submit: %.3f ms", stats.PreprocessMilliseconds, stats.SubmitMilliseconds);
+		ImGui::Text("Latency avg: %.3f ms  max: %.3f ms", stats.GetAverageLatency(), stats.MaxLatencyMilliseconds);
+		ImGui::Text("Compile all parallel: %.3f ms%s", m_ParallelMilliseconds, m_ParallelRunning ? " (running)" : "");
+		ImGui::Text("Compile all sequential: %.3f ms", m_SequentialMilliseconds);
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Test.h"
+#include "glm/glm.hpp"
+#include <chrono>
+#include <memory>
+
+class VertexArray;
+class VertexBuffer;
+class IndexBuffer;
+class Texture;
+class ShaderVariants;
+
+namespace Test {
+
+	// 着色器变体：勾选开关组合出 key，绘制时按 key 查找变体；
+	// 比较所有变体并行编译（提交后每帧轮询）和逐个阻塞编译的耗时
+	class TestShaderVariants : public Test
+	{
+	public:
+		TestShaderVariants();
+		~TestShaderVariants();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		// 每次重建都换一个 salt，避免驱动的着色器缓存让编译时间失真
+		void Recreate();
+		void CompileAllParallel();
+		void CompileAllSequential();
+
+	private:
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Texture> m_Texture;
+		std::unique_ptr<ShaderVariants> m_Variants;
+		glm::mat4 m_ProjectionMatrix;
+
+		bool m_Enabled[32];
+		unsigned int m_DrawnKey;    // 实际绘制的变体，请求的变体还没编译完时沿用上一个
+		unsigned int m_Salt;
+		// 决定需要设置哪些 uniform，未使用的 uniform 会被编译器去掉
+		unsigned int m_TexturedKey, m_TintKey, m_AnimateKey;
+		float m_Time;
+
+		bool m_ParallelRunning;
+		std::chrono::high_resolution_clock::time_point m_ParallelStart;
+		double m_ParallelMilliseconds;
+		double m_SequentialMilliseconds;
+	};
+
+}
@@ -0,0 +1,110 @@
+#include "TestSpriteOverdraw.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <chrono>
+#include <random>
+
+namespace Test {
+
+	TestSpriteOverdraw::TestSpriteOverdraw()
+		: m_SpriteCount(2000)
+		, m_TranslucentPercent(10)
+		, m_Seed(12777)
+		, m_DepthSorting(true)
+		, m_OverdrawVisualization(false)
+		, m_ProjectionMatrix(glm::ortho<float>(1920.f / 1080.f * -50.f, 1920.f / 1080.f * 50.f, -50.f, 50.f, -1.0f, 1.0f))
+		, m_SubmitMilliseconds(0.0)
+		, m_ViewportPixels(1)
+	{
+		m_SpriteRenderer = std::make_unique<SpriteRenderer>();
+		m_OpaqueTexture = std::make_unique<Texture>("res/textures/IMG_20220707_191336.jpg");
+		m_AlphaTexture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+
+		GenerateSprites();
+	}
+
+	TestSpriteOverdraw::~TestSpriteOverdraw()
+	{
+	}
+
+	void TestSpriteOverdraw::GenerateSprites()
+	{
+		// 固定种子，保证每次对比的场景相同
+		std::mt19937 rng(m_Seed);
+		std::uniform_real_distribution<float> x(1920.f / 1080.f * -50.f, 1920.f / 1080.f * 50.f);
+		std::uniform_real_distribution<float> y(-50.f, 50.f);
+		std::uniform_real_distribution<float> size(8.f, 30.f);
+		std::uniform_real_distribution<float> depth(-0.99f, 0.99f);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+		m_Sprites.clear();
+		m_Sprites.reserve(m_SpriteCount);
+		for (int i = 0; i < m_SpriteCount; i++)
+		{
+			Sprite sprite;
+			sprite.Position = glm::vec3(x(rng), y(rng), depth(rng));
+			float s = size(rng);
+			sprite.Size = glm::vec2(s * 4.f / 3.f, s);
+			sprite.SpriteTexture = unit(rng) < 0.5f ? m_OpaqueTexture.get() : m_AlphaTexture.get();
+			sprite.Color = glm::vec4(0.5f + 0.5f * unit(rng), 0.5f + 0.5f * unit(rng), 0.5f + 0.5f * unit(rng), 1.f);
+			if (unit(rng) * 100.f < (float)m_TranslucentPercent)
+				sprite.Color.a = 0.6f;
+			m_Sprites.push_back(sprite);
+		}
+	}
+
+	void TestSpriteOverdraw::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestSpriteOverdraw::OnRender()
+	{
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		m_ViewportPixels = viewport[2] * viewport[3] > 0 ? viewport[2] * viewport[3] : 1;
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		m_SpriteRenderer->SetDepthSorting(m_DepthSorting);
+		m_SpriteRenderer->SetOverdrawVisualization(m_OverdrawVisualization);
+		m_SpriteRenderer->Begin(m_ProjectionMatrix);
+		for (const Sprite& sprite : m_Sprites)
+			m_SpriteRenderer->Submit(sprite);
+		m_SpriteRenderer->End();
+
+		m_SubmitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void TestSpriteOverdraw::OnImGuiRender()
+	{
+		bool regenerate = false;
+		regenerate |= ImGui::SliderInt("Sprites", &m_SpriteCount, 100, 20000);
+		regenerate |= ImGui::SliderInt("Translucent %", &m_TranslucentPercent, 0, 100);
+		if (ImGui::Button("Reseed"))
+		{
+			m_Seed++;
+			regenerate = true;
+		}
+		if (regenerate)
+			GenerateSprites();
+
+		ImGui::Checkbox("Depth Sorting (opaque front-to-back)", &m_DepthSorting);
+		ImGui::Checkbox("Overdraw Visualization", &m_OverdrawVisualization);
+
+		const SpriteRenderStats& stats = m_SpriteRenderer->GetStats();
+		ImGui::Separator();
+		ImGui::Text("Opaque %u  AlphaTested %u  Translucent %u", stats.OpaqueCount, stats.AlphaTestedCount, stats.TranslucentCount);
+		ImGui::Text("Draw Calls: %u", stats.DrawCalls);
+		ImGui::Text("Samples Passed: %llu", stats.SamplesPassed);
+		ImGui::Text("Overdraw: %.2fx", (double)stats.SamplesPassed / (double)m_ViewportPixels);
+		ImGui::Text("CPU Submit: %.3f ms", m_SubmitMilliseconds);
+	}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Test.h"
+#include "SpriteRenderer.h"
+#include "glm/glm.hpp"
+#include <memory>
+#include <vector>
+
+class Texture;
+
+namespace Test {
+
+	// 大量重叠精灵的 overdraw 对比：按 alpha 分类 + 深度排序 vs 全部混合
+	class TestSpriteOverdraw : public Test
+	{
+	public:
+		TestSpriteOverdraw();
+		~TestSpriteOverdraw();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		void GenerateSprites();
+
+	private:
+		int m_SpriteCount;
+		int m_TranslucentPercent;
+		unsigned int m_Seed;
+		bool m_DepthSorting;
+		bool m_OverdrawVisualization;
+		glm::mat4 m_ProjectionMatrix;
+
+		std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
+		std::unique_ptr<Texture> m_OpaqueTexture, m_AlphaTexture;
+		std::vector<Sprite> m_Sprites;
+
+		double m_SubmitMilliseconds;
+		int m_ViewportPixels;
+	};
+
+}
@@ -0,0 +1,181 @@
+#include "TestText.h"
+
+#include "Renderer.h"
+#include "Font.h"
+#include "GlyphAtlas.h"
+#include "TextRenderer.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace Test {
+
+	namespace {
+
+		const int AtlasSizes[] = { 256, 512, 1024, 2048 };
+
+		const char* Words[] = {
+			"Player", "Enemy", "Health", "Mana", "Quest", "Gold", "Tower", "Bridge",
+			"Caf\xC3\xA9", "\xC3\x86r\xC3\xB8", "Na\xC3\xAFve", "Stra\xC3\x9F" "e", "AVATAR", "Wave", "Kerning", "Typography",
+		};
+
+	}
+
+	TestText::TestText()
+		: m_AtlasSizeIndex(2)
+		, m_LabelCount(2000)
+		, m_LabelSize(18.f)
+		, m_HeaderSize(96.f)
+		, m_Seed(12777)
+		, m_LayoutMilliseconds(0.0)
+		, m_SubmitMilliseconds(0.0)
+		, m_GPUMilliseconds(0.0)
+		, m_Frame(0)
+	{
+		// 仓库里没有附带字体，优先使用 res/fonts/Default.ttf，否则使用系统字体
+		snprintf(m_FontPath, sizeof(m_FontPath), "%s", "res/fonts/Default.ttf");
+		if (!std::ifstream(m_FontPath).good())
+			snprintf(m_FontPath, sizeof(m_FontPath), "%s", "C:/Windows/Fonts/arial.ttf");
+
+		m_TextRenderer = std::make_unique<TextRenderer>();
+		glGenQueries(2, m_TimerQueries);
+
+		LoadFont();
+		GenerateLabels();
+	}
+
+	TestText::~TestText()
+	{
+		glDeleteQueries(2, m_TimerQueries);
+	}
+
+	void TestText::LoadFont()
+	{
+		m_Atlas.reset();
+		m_Font = std::make_unique<Font>(m_FontPath);
+		if (!m_Font->IsValid())
+		{
+			m_Font.reset();
+			return;
+		}
+		m_Atlas = std::make_unique<GlyphAtlas>(*m_Font, AtlasSizes[m_AtlasSizeIndex]);
+	}
+
+	void TestText::GenerateLabels()
+	{
+		std::mt19937 rng(m_Seed);
+		std::uniform_real_distribution<float> x(0.f, 1800.f);
+		std::uniform_real_distribution<float> y(0.f, 1000.f);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+		std::uniform_int_distribution<int> word(0, (int)(sizeof(Words) / sizeof(Words[0])) - 1);
+
+		m_Labels.clear();
+		m_Labels.reserve(m_LabelCount);
+		char buffer[64];
+		for (int i = 0; i < m_LabelCount; i++)
+		{
+			snprintf(buffer, sizeof(buffer), "%s #%d", Words[word(rng)], i);
+			Label label;
+			label.Text = buffer;
+			label.Position = glm::vec2(x(rng), y(rng));
+			label.Size = m_LabelSize * (0.75f + 0.5f * unit(rng));
+			label.Color = glm::vec4(0.6f + 0.4f * unit(rng), 0.6f + 0.4f * unit(rng), 0.6f + 0.4f * unit(rng), 1.f);
+			m_Labels.push_back(label);
+		}
+	}
+
+	void TestText::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestText::OnRender()
+	{
+		glClearColor(0.1f, 0.1f, 0.12f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		if (!m_Atlas)
+			return;
+
+		// 读取上一帧的 GPU 时间，不等待当前帧
+		if (m_Frame > 0)
+		{
+			GLint available = 0;
+			glGetQueryObjectiv(m_TimerQueries[(m_Frame + 1) % 2], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available)
+			{
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(m_TimerQueries[(m_Frame + 1) % 2], GL_QUERY_RESULT, &elapsed);
+				m_GPUMilliseconds = elapsed / 1000000.0;
+			}
+		}
+		glBeginQuery(GL_TIME_ELAPSED, m_TimerQueries[m_Frame % 2]);
+
+		// 以像素为单位的正交投影，y 向上
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glm::mat4 projection = glm::ortho(0.f, (float)viewport[2], 0.f, (float)viewport[3], -1.f, 1.f);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		m_TextRenderer->Begin(projection);
+		m_TextRenderer->SubmitText(*m_Atlas, "SDF Text\nAVATAR Wave Typography", glm::vec2(40.f, viewport[3] - m_HeaderSize), m_HeaderSize, glm::vec4(1.f, 0.85f, 0.4f, 1.f));
+		for (const Label& label : m_Labels)
+			m_TextRenderer->SubmitText(*m_Atlas, label.Text, label.Position, label.Size, label.Color);
+
+		auto layoutEnd = std::chrono::high_resolution_clock::now();
+		m_TextRenderer->End();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		glEndQuery(GL_TIME_ELAPSED);
+		m_Frame++;
+
+		m_LayoutMilliseconds = std::chrono::duration<double, std::milli>(layoutEnd - start).count();
+		m_SubmitMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	void TestText::OnImGuiRender()
+	{
+		ImGui::InputText("Font", m_FontPath, sizeof(m_FontPath));
+		bool reload = ImGui::Button("Load Font");
+		ImGui::SameLine();
+		reload |= ImGui::Combo("Atlas Size", &m_AtlasSizeIndex, "256\0" "512\0" "1024\0" "2048\0");
+		if (reload)
+			LoadFont();
+
+		bool regenerate = false;
+		regenerate |= ImGui::SliderInt("Labels", &m_LabelCount, 0, 20000);
+		regenerate |= ImGui::SliderFloat("Label Size", &m_LabelSize, 6.f, 64.f);
+		ImGui::SliderFloat("Header Size", &m_HeaderSize, 12.f, 256.f);
+		if (ImGui::Button("Reseed"))
+		{
+			m_Seed++;
+			regenerate = true;
+		}
+		if (regenerate)
+			GenerateLabels();
+
+		if (!m_Atlas)
+		{
+			ImGui::TextColored(ImVec4(1.f, 0.4f, 0.4f, 1.f), "Failed to load font");
+			return;
+		}
+
+		const TextRenderStats& stats = m_TextRenderer->GetStats();
+		const GlyphAtlasStats& atlasStats = m_Atlas->GetStats();
+		ImGui::Separator();
+		ImGui::Text("Glyphs: %u  Draw Calls: %u  Eviction Flushes: %u", stats.Glyphs, stats.DrawCalls, stats.EvictionFlushes);
+		ImGui::Text("Layout: %.3f ms (%.0f glyphs/ms)", m_LayoutMilliseconds, m_LayoutMilliseconds > 0.0 ? stats.Glyphs / m_LayoutMilliseconds : 0.0);
+		ImGui::Text("Layout + Upload + Draw: %.3f ms (%.0f glyphs/ms)", m_SubmitMilliseconds, m_SubmitMilliseconds > 0.0 ? stats.Glyphs / m_SubmitMilliseconds : 0.0);
+		ImGui::Text("GPU: %.3f ms", m_GPUMilliseconds);
+		ImGui::Text("Atlas: %u resident, %u rasterized (%.1f ms), %u evicted, %u shelves",
+			atlasStats.ResidentGlyphs, atlasStats.Rasterized, atlasStats.RasterizeMilliseconds, atlasStats.Evictions, atlasStats.ShelfCount);
+
+		if (ImGui::CollapsingHeader("Atlas"))
+			ImGui::Image((ImTextureID)(intptr_t)m_Atlas->GetRendererID(), ImVec2(256.f, 256.f));
+	}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Test.h"
+#include "glm/glm.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+class Font;
+class GlyphAtlas;
+class TextRenderer;
+
+namespace Test {
+
+	// SDF 文字批量渲染：大量标签 + 排版/渲染速度统计
+	class TestText : public Test
+	{
+	public:
+		TestText();
+		~TestText();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::OnInput; }
+
+	private:
+		struct Label
+		{
+			std::string Text;
+			glm::vec2 Position;
+			float Size;
+			glm::vec4 Color;
+		};
+
+		void LoadFont();
+		void GenerateLabels();
+
+	private:
+		char m_FontPath[256];
+		int m_AtlasSizeIndex;
+		int m_LabelCount;
+		float m_LabelSize;
+		float m_HeaderSize;
+		unsigned int m_Seed;
+
+		std::unique_ptr<Font> m_Font;
+		std::unique_ptr<GlyphAtlas> m_Atlas;
+		std::unique_ptr<TextRenderer> m_TextRenderer;
+		std::vector<Label> m_Labels;
+
+		double m_LayoutMilliseconds;
+		double m_SubmitMilliseconds;
+		double m_GPUMilliseconds;
+		unsigned int m_TimerQueries[2];
+		unsigned int m_Frame;
+	};
+
+}
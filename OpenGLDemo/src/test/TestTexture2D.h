@@ -4,11 +4,8 @@
 #include "glm/glm.hpp"
 #include <memory>
 
-class VertexArray;
-class VertexBuffer;
-class IndexBuffer;
-class Shader;
 class Texture;
+class SpriteRenderer;
 
 namespace Test {
 
@@ -21,15 +18,13 @@ namespace Test {
 		virtual void OnUpdate(float deltaTime) override;
 		virtual void OnRender() override;
 		virtual void OnImGuiRender() override;
+		virtual RedrawPolicy GetRedrawPolicy() const override { return RedrawPolicy::OnInput; }
 
 	private:
 		glm::vec3 m_TranslationA, m_TranslationB;
 		glm::mat4 m_ProjectionMatrix, m_ViewMatrix;
 
-		std::unique_ptr<VertexArray> m_VAO;
-		std::unique_ptr<VertexBuffer> m_VBO;
-		std::unique_ptr<IndexBuffer> m_IBO;
-		std::unique_ptr<Shader> m_ShaderProgram;
+		std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
 		std::unique_ptr<Texture> m_Texture2DA, m_Texture2DB;
 	};
 
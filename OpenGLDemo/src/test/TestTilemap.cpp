@@ -0,0 +1,236 @@
+#include "TestTilemap.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "Tilemap.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace Test {
+
+	namespace {
+
+		const int MapSize = 4096;
+		const int AtlasColumns = 8;         // 每种地形 8 个变体
+		const int AtlasRows = 8;            // 8 种地形
+		const int AtlasTilePixels = 16;
+
+		enum TerrainType
+		{
+			Water, Sand, Grass, Forest, Stone, Snow, Road, Brick
+		};
+
+		const unsigned char TerrainColors[AtlasRows][3] = {
+			{ 40, 90, 170 }, { 210, 190, 130 }, { 80, 150, 60 }, { 40, 100, 40 },
+			{ 120, 120, 120 }, { 235, 240, 245 }, { 150, 110, 70 }, { 160, 60, 50 },
+		};
+
+		unsigned int Hash(unsigned int x, unsigned int y, unsigned int seed)
+		{
+			unsigned int h = x * 374761393u + y * 668265263u + seed * 2246822519u;
+			h = (h ^ (h >> 13)) * 1274126177u;
+			return h ^ (h >> 16);
+		}
+
+		float ValueNoise(float x, float y, unsigned int seed)
+		{
+			int ix = (int)std::floor(x), iy = (int)std::floor(y);
+			float fx = x - ix, fy = y - iy;
+			fx = fx * fx * (3.f - 2.f * fx);
+			fy = fy * fy * (3.f - 2.f * fy);
+			auto corner = [seed](int cx, int cy) { return (Hash((unsigned int)cx, (unsigned int)cy, seed) & 0xFFFF) / 65535.f; };
+			float a = corner(ix, iy), b = corner(ix + 1, iy), c = corner(ix, iy + 1), d = corner(ix + 1, iy + 1);
+			return (a + (b - a) * fx) + ((c + (d - c) * fx) - (a + (b - a) * fx)) * fy;
+		}
+
+		unsigned short TileId(int terrain, unsigned int variant)
+		{
+			return (unsigned short)(terrain * AtlasColumns + (int)(variant % AtlasColumns) + 1);
+		}
+
+	}
+
+	TestTilemap::TestTilemap()
+		: m_Random(1234)
+		, m_Center(MapSize * 0.5f, MapSize * 0.5f)
+		, m_ViewHeight(128.f)
+		, m_AutoPan(false)
+		, m_PanTime(0.f)
+		, m_ViewMin(0.f)
+		, m_ViewMax(0.f)
+		, m_BrushTile(Brick)
+		, m_BrushRadius(2)
+		, m_EditsPerFrame(0)
+		, m_MaxBuildsPerFrame(256)
+		, m_MultiDraw(false)
+		, m_ThreadedBuild(true)
+		, m_GenerateMilliseconds(0.0)
+		, m_MeasuredEdits(0)
+		, m_MeasuredMilliseconds(0.0)
+		, m_MeasuredChunks(0)
+	{
+		GenerateAtlas();
+		m_Tilemap = std::make_unique<Tilemap>(MapSize, MapSize, m_Atlas.get(), AtlasColumns, AtlasRows);
+		GenerateTerrain();
+	}
+
+	TestTilemap::~TestTilemap()
+	{
+	}
+
+	void TestTilemap::GenerateAtlas()
+	{
+		const int width = AtlasColumns * AtlasTilePixels;
+		const int height = AtlasRows * AtlasTilePixels;
+		std::vector<unsigned char> pixels((size_t)width * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				int row = y / AtlasTilePixels, column = x / AtlasTilePixels;
+				int lx = x % AtlasTilePixels, ly = y % AtlasTilePixels;
+				// 每个变体不同的噪点，边缘稍暗，便于看清瓦片边界
+				float shade = 0.85f + 0.15f * ((Hash(x, y, column) & 0xFF) / 255.f);
+				if (lx == 0 || ly == 0)
+					shade *= 0.8f;
+				unsigned char* pixel = &pixels[((size_t)y * width + x) * 4];
+				for (int c = 0; c < 3; c++)
+					pixel[c] = (unsigned char)std::min(255.f, TerrainColors[row][c] * shade);
+				pixel[3] = 255;
+			}
+		}
+		m_Atlas = std::make_unique<Texture>(width, height, pixels.data());
+	}
+
+	void TestTilemap::GenerateTerrain()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int y = 0; y < MapSize; y++)
+		{
+			for (int x = 0; x < MapSize; x++)
+			{
+				float height = ValueNoise(x / 256.f, y / 256.f, 1) * 0.6f
+					+ ValueNoise(x / 64.f, y / 64.f, 2) * 0.3f
+					+ ValueNoise(x / 16.f, y / 16.f, 3) * 0.1f;
+				int terrain = height < 0.38f ? Water
+					: height < 0.42f ? Sand
+					: height < 0.55f ? Grass
+					: height < 0.65f ? Forest
+					: height < 0.75f ? Stone : Snow;
+				m_Tilemap->SetTile(x, y, TileId(terrain, Hash(x, y, 7)));
+			}
+		}
+		m_GenerateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void TestTilemap::Paint(const glm::vec2& center)
+	{
+		int cx = (int)std::floor(center.x), cy = (int)std::floor(center.y);
+		for (int y = cy - m_BrushRadius; y <= cy + m_BrushRadius; y++)
+		{
+			for (int x = cx - m_BrushRadius; x <= cx + m_BrushRadius; x++)
+			{
+				if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= m_BrushRadius * m_BrushRadius)
+					m_Tilemap->SetTile(x, y, TileId(m_BrushTile, Hash(x, y, 11)));
+			}
+		}
+	}
+
+	void TestTilemap::OnUpdate(float deltaTime)
+	{
+		if (m_AutoPan)
+		{
+			m_PanTime += deltaTime;
+			m_Center.x = MapSize * 0.5f + std::cos(m_PanTime * 0.1f) * MapSize * 0.35f;
+			m_Center.y = MapSize * 0.5f + std::sin(m_PanTime * 0.13f) * MapSize * 0.35f;
+		}
+
+		// 随机修改视野内的瓦片
+		if (m_EditsPerFrame > 0 && m_ViewMax.x > m_ViewMin.x)
+		{
+			std::uniform_real_distribution<float> rx(m_ViewMin.x, m_ViewMax.x), ry(m_ViewMin.y, m_ViewMax.y);
+			std::uniform_int_distribution<int> terrain(Water, Brick);
+			for (int i = 0; i < m_EditsPerFrame; i++)
+			{
+				int x = (int)rx(m_Random), y = (int)ry(m_Random);
+				m_Tilemap->SetTile(x, y, TileId(terrain(m_Random), m_Random()));
+			}
+		}
+
+		// 鼠标不在 ImGui 窗口上时左键绘制
+		ImGuiIO& io = ImGui::GetIO();
+		if (!io.WantCaptureMouse && io.MouseDown[0] && io.DisplaySize.x > 0.f && io.DisplaySize.y > 0.f)
+		{
+			glm::vec2 uv(io.MousePos.x / io.DisplaySize.x, 1.f - io.MousePos.y / io.DisplaySize.y);
+			Paint(m_ViewMin + (m_ViewMax - m_ViewMin) * uv);
+		}
+	}
+
+	void TestTilemap::OnRender()
+	{
+		GLCALL(glClearColor(0.f, 0.f, 0.f, 1.f));
+		GLCALL(glClear(GL_COLOR_BUFFER_BIT));
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		float aspect = viewport[3] > 0 ? (float)viewport[2] / (float)viewport[3] : 16.f / 9.f;
+		glm::vec2 halfSize(m_ViewHeight * aspect * 0.5f, m_ViewHeight * 0.5f);
+		m_ViewMin = m_Center - halfSize;
+		m_ViewMax = m_Center + halfSize;
+		glm::mat4 projection = glm::ortho(m_ViewMin.x, m_ViewMax.x, m_ViewMin.y, m_ViewMax.y, -1.f, 1.f);
+
+		m_Tilemap->SetMaxBuildsPerFrame((unsigned int)m_MaxBuildsPerFrame);
+		m_Tilemap->SetMultiDraw(m_MultiDraw);
+		m_Tilemap->SetThreadedBuild(m_ThreadedBuild);
+		m_Tilemap->Render(projection, m_ViewMin, m_ViewMax);
+
+		const TilemapStats& stats = m_Tilemap->GetStats();
+		if (stats.Edits > 0 && stats.ChunksStreamed == 0)
+		{
+			m_MeasuredEdits += stats.Edits;
+			m_MeasuredChunks += stats.ChunksRebuilt;
+			m_MeasuredMilliseconds += stats.BuildMilliseconds + stats.UploadMilliseconds;
+		}
+	}
+
+	void TestTilemap::OnImGuiRender()
+	{
+		const TilemapStats& stats = m_Tilemap->GetStats();
+		ImGui::Text("Map %dx%d, %u chunks of %dx%d, generated in %.1f ms", MapSize, MapSize, m_Tilemap->GetChunkCount(), Tilemap::ChunkSize, Tilemap::ChunkSize, m_GenerateMilliseconds);
+
+		ImGui::DragFloat2("Camera", &m_Center.x, 1.f, 0.f, (float)MapSize);
+		ImGui::SliderFloat("View Height (tiles)", &m_ViewHeight, 16.f, 1024.f, "%.0f", 2.f);
+		ImGui::Checkbox("Auto Pan", &m_AutoPan);
+
+		static const char* terrainNames[] = { "Water", "Sand", "Grass", "Forest", "Stone", "Snow", "Road", "Brick" };
+		ImGui::Combo("Brush", &m_BrushTile, terrainNames, AtlasRows);
+		ImGui::SliderInt("Brush Radius", &m_BrushRadius, 0, 16);
+		ImGui::SliderInt("Random Edits / Frame", &m_EditsPerFrame, 0, 2000);
+
+		ImGui::SliderInt("Max Builds / Frame", &m_MaxBuildsPerFrame, 1, 1024);
+		ImGui::Checkbox("Multi Draw", &m_MultiDraw);
+		ImGui::Checkbox("Threaded Build", &m_ThreadedBuild);
+
+		ImGui::Separator();
+		ImGui::Text("Chunks: %u visible, %u resident (max %u), %u pending", stats.VisibleChunks, stats.ResidentChunks, m_Tilemap->GetMaxResidentChunks(), stats.PendingChunks);
+		ImGui::Text("Draw calls: %u (per-tile submission: %u)", stats.DrawCalls, stats.QuadsDrawn);
+		ImGui::Text("Edits: %u  rebuilt: %u  streamed: %u", stats.Edits, stats.ChunksRebuilt, stats.ChunksStreamed);
+		ImGui::Text("Cull %.3f ms  build %.3f ms  upload %.3f ms", stats.CullMilliseconds, stats.BuildMilliseconds, stats.UploadMilliseconds);
+		if (m_MeasuredEdits > 0)
+		{
+			ImGui::Text("Rebuild cost: %.4f ms/edit, %.4f ms/chunk", m_MeasuredMilliseconds / m_MeasuredEdits, m_MeasuredChunks > 0 ? m_MeasuredMilliseconds / m_MeasuredChunks : 0.0);
+		}
+		if (ImGui::Button("Reset Measurements"))
+		{
+			m_MeasuredEdits = 0;
+			m_MeasuredMilliseconds = 0.0;
+			m_MeasuredChunks = 0;
+		}
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Test.h"
+#include "glm/glm.hpp"
+#include <memory>
+#include <random>
+
+class Texture;
+class Tilemap;
+
+namespace Test {
+
+	// 4096x4096 瓦片地图基准：程序生成地形和图集，统计每帧绘制次数和每次修改的重建开销。
+	// 左键在地图上绘制，或者每帧在视野内随机修改若干瓦片
+	class TestTilemap : public Test
+	{
+	public:
+		TestTilemap();
+		~TestTilemap();
+
+		virtual void OnUpdate(float deltaTime) override;
+		virtual void OnRender() override;
+		virtual void OnImGuiRender() override;
+
+	private:
+		void GenerateAtlas();
+		void GenerateTerrain();
+		void Paint(const glm::vec2& center);
+
+	private:
+		std::unique_ptr<Texture> m_Atlas;
+		std::unique_ptr<Tilemap> m_Tilemap;
+		std::mt19937 m_Random;
+
+		glm::vec2 m_Center;
+		float m_ViewHeight;         // 视野高度（瓦片数）
+		bool m_AutoPan;
+		float m_PanTime;
+		glm::vec2 m_ViewMin, m_ViewMax;
+
+		int m_BrushTile;
+		int m_BrushRadius;
+		int m_EditsPerFrame;
+		int m_MaxBuildsPerFrame;
+		bool m_MultiDraw;
+		bool m_ThreadedBuild;
+
+		double m_GenerateMilliseconds;
+		// 只统计有修改且没有新区块进入视野的帧，避免流式构建混入重建开销
+		unsigned long long m_MeasuredEdits;
+		double m_MeasuredMilliseconds;
+		unsigned int m_MeasuredChunks;
+	};
+
+}